@@ -5,23 +5,121 @@
 #include "View/MainWindow.h"
 #include "Model/VnaScpiClient.h"
 #include "Model/VnaConfig.h"
+#include "Model/SweepCodecBenchmark.h"
+#include "Model/SweepShmBenchmark.h"
+#include "Model/Metrics.h"
 #include "Presenter/MeasurementPresenter.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 
 int main(int argc, char *argv[])
 {
+    // Startup phases are measured from here (see --profile-startup).
+    Metrics& metrics = Metrics::instance();
     QApplication app(argc, argv);
     QCoreApplication::setApplicationName("MyTestTask");
+    metrics.markStartup("application");
 
+    // Command line options.
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption renderRateOption("render-rate", "Display refresh cap, Hz.", "hz", "60");
+    parser.addOption(renderRateOption);
+    QCommandLineOption captureOption("capture", "Capture the raw SCPI traffic to a file.", "file");
+    parser.addOption(captureOption);
+    QCommandLineOption replayOption("replay", "Replay a SCPI capture instead of the instrument.", "file");
+    parser.addOption(replayOption);
+    QCommandLineOption replayFastOption("replay-fast", "Replay as fast as possible (not at recorded speed).");
+    parser.addOption(replayFastOption);
+    QCommandLineOption metricsPortOption("metrics-port", "Serve Prometheus metrics on 127.0.0.1:<port> (0 = off).", "port", "0");
+    parser.addOption(metricsPortOption);
+    QCommandLineOption muxPortOption("mux-port", "Share the instrument with local clients on 127.0.0.1:<port> (0 = off).", "port", "0");
+    parser.addOption(muxPortOption);
+    QCommandLineOption pipelineOption("pipeline", "Processing stage order.", "stages", "parse,deembed,math,format,waterfall,limit");
+    parser.addOption(pipelineOption);
+    QCommandLineOption shmOption("shm", "Publish every sweep to POSIX shared memory /<name> (see SweepShmReader.h).", "name");
+    parser.addOption(shmOption);
+    QCommandLineOption trendDirOption("trend-dir", "Record marker / band trends into this directory.", "dir");
+    parser.addOption(trendDirOption);
+    QCommandLineOption trendOption("trend", "Trend channels, GHz: markers and bands, e.g. 1.5,2.0-2.5.", "channels", "1.0");
+    parser.addOption(trendOption);
+    QCommandLineOption recordOption("record", "Record every raw sweep into a compressed file (see SweepRecording.h).", "file");
+    parser.addOption(recordOption);
+    QCommandLineOption codecBenchOption("codec-bench", "Benchmark the sweep recording (write, random read, truncated file) on synthetic sweeps and the --replay capture, then exit.");
+    parser.addOption(codecBenchOption);
+    QCommandLineOption shmBenchOption("shm-bench", "Measure the shared-memory handoff latency of 10001-point sweeps, then exit.");
+    parser.addOption(shmBenchOption);
+    QCommandLineOption noConnectOption("no-connect", "Do not connect to the instrument before \"Measure\" is clicked.");
+    parser.addOption(noConnectOption);
+    QCommandLineOption profileStartupOption("profile-startup", "Print the time of each startup phase (up to the first trace) to stderr.");
+    parser.addOption(profileStartupOption);
+    parser.process(app);
+    metrics.setStartupPrint(parser.isSet(profileStartupOption));
+
+    // Codec benchmark: no window, no instrument.
+    if (parser.isSet(codecBenchOption)) {
+        QTextStream out(stdout);
+        runSweepCodecBenchmark("synthetic", syntheticSweeps(256, 10001), out);
+        if (parser.isSet(replayOption)) {
+            QVector<SweepPtr> sweeps;
+            QString error;
+            if (capturedSweeps(parser.value(replayOption), sweeps, &error)) {
+                runSweepCodecBenchmark("captured", sweeps, out);
+            } else {
+                out << "captured: " << error << "\n";
+            }
+        }
+        return 0;
+    }
+
+    // Shared-memory handoff benchmark: publisher and reader in this process.
+    if (parser.isSet(shmBenchOption)) {
+        QTextStream out(stdout);
+        return runSweepShmBenchmark(10000, 10001, out) ? 0 : 1;
+    }
+
+    // The window is built without its chart (added after the first paint), the
+    // Worker thread starts with the Presenter and connects while the chart is built.
     VnaConfigModel config;
     MainWindow view;
+    metrics.markStartup("window");
 
     MeasurementPresenter presenter(&view, &config);
+    metrics.markStartup("presenter");
+    presenter.setRenderRate(parser.value(renderRateOption).toInt());
+
+    ScpiTransportOptions transport;
+    transport.capturePath = parser.value(captureOption);
+    transport.replayPath = parser.value(replayOption);
+    transport.replayRealTime = !parser.isSet(replayFastOption);
+    presenter.setTransportOptions(transport);
+    presenter.setMetricsPort(quint16(parser.value(metricsPortOption).toUInt()));
+    presenter.setMuxPort(quint16(parser.value(muxPortOption).toUInt()));
+    if (!parser.isSet(noConnectOption)) presenter.connectOnStartup();
+
+    QString shmError;
+    if (parser.isSet(shmOption) && !presenter.setSharedMemoryName(parser.value(shmOption), &shmError))
+        qWarning("Shared memory: %s", qPrintable(shmError));
+
+    QString trendError;
+    if (parser.isSet(trendDirOption)
+        && !presenter.setTrendRecording(parser.value(trendDirOption), parser.value(trendOption), &trendError))
+        qWarning("Trend: %s", qPrintable(trendError));
+
+    QString recordError;
+    if (parser.isSet(recordOption) && !presenter.setSweepRecording(parser.value(recordOption), &recordError))
+        qWarning("Record: %s", qPrintable(recordError));
+
+    QString pipelineError;
+    if (!presenter.setPipelineOrder(parser.value(pipelineOption).split(',', Qt::SkipEmptyParts), &pipelineError))
+        qWarning("Pipeline: %s", qPrintable(pipelineError));
 
     // Show View.
+    metrics.markStartup("configured");
     view.show();
+    metrics.markStartup("show");
 
     return app.exec();
 }
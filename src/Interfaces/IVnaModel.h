@@ -4,6 +4,8 @@
 #ifndef IVNAMODEL_H
 #define IVNAMODEL_H
 
+#include "Model/SweepData.h"
+
 #include <QString>
 #include <QObject>
 
@@ -41,6 +43,15 @@ public:
     // Method for requesting the data graph from a socket from the S2VNA with SCPI.
     virtual void requestSParamsGraph() = 0;
 
+    // Trigger one sweep for a test sequence step. sweepCompleted(tag) is emitted as soon
+    // as the instrument finished sweeping (*OPC?), before the data is transferred.
+    virtual void requestSequenceSweep(quint64 tag) = 0;
+
+    // Send a raw SCPI command line on behalf of an external client.
+    // Every line containing a query ('?' outside quoted strings) gets one reply line,
+    // returned with the same tag, or "ERR no reply" if the instrument stays silent.
+    virtual void sendRaw(quint64 tag, const QByteArray& commandLine) = 0;
+
 signals:
     // Successful connection to socket.
     void connected();
@@ -55,8 +66,20 @@ signals:
                                 double power,
                                 int ifBw);
 
-    // We receive graph data from the socket and update the X-axis.
-    void sParametersReceived(const QString& rawData);
+    // We receive graph data from the socket (already converted, grid not set yet).
+    void sParametersReceived(const SweepPtr& sweep);
+
+    // The same sweep as the raw reply bytes (implicitly shared, for fan-out).
+    void sweepBytesReceived(const QByteArray& rawData);
+
+    // Sequence sweep finished on the instrument (data still to come).
+    void sweepCompleted(quint64 tag);
+
+    // Data of a sequence sweep (emitted before sParametersReceived of the same sweep).
+    void taggedSweepReceived(quint64 tag, const SweepPtr& sweep);
+
+    // Reply line to a raw command.
+    void rawReplyReceived(quint64 tag, const QByteArray& reply);
 
 };
 
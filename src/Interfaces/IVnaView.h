@@ -3,6 +3,8 @@
 #ifndef IVNAVIEW_H
 #define IVNAVIEW_H
 
+#include "Model/TrendStore.h"
+
 #include <QMainWindow>
 #include <QVector>
 #include <QObject>
@@ -35,6 +37,27 @@ public:
                                 double startFreq,
                                 double stopFreq) = 0;
 
+    // Update the frame counters (processed / displayed / dropped).
+    virtual void onFrameStats(quint64 processed,
+                                quint64 displayed,
+                                quint64 dropped) = 0;
+
+    // Append the sweep magnitude (dB) to the waterfall history.
+    virtual void onWaterfallUpdated(const QVector<double>& magDb) = 0;
+
+    // Show the trend buckets of the requested time range.
+    virtual void onTrendUpdated(const TrendSeries& series) = 0;
+
+    // Refresh rate predicted for the current points / IF bandwidth and the achieved one, Hz.
+    virtual void onTuneStatus(double predictedHz,
+                                double achievedHz) = 0;
+
+    // Update the limit test verdict (pass/fail, worst margin and its frequency).
+    virtual void onLimitVerdict(bool passed,
+                                double worstMarginDb,
+                                double worstFreqMhz,
+                                int failedPoints) = 0;
+
 signals:
     // Button click signal to send data to Presenter.
     void measureRequested(double startFreq,
@@ -42,6 +65,43 @@ signals:
                             int points,
                             double power,
                             int ifBw);
+
+    // Limit mask file selected by the user.
+    void limitMaskRequested(const QString& path);
+
+    // Test plan file selected by the user (run once for the next DUT).
+    void sequenceRequested(const QString& planPath);
+
+    // Touchstone export: format (RI/MA/DB), version (1/2),
+    // everyN = 0 exports the current sweep, everyN > 0 every Nth sweep (numbered files).
+    void touchstoneExportRequested(const QString& path,
+                                    int format,
+                                    int version,
+                                    int everyN);
+
+    // Displayed trace format selected by the user (TraceFormat value).
+    void traceFormatChanged(int format);
+
+    // Group delay aperture selected by the user, steps.
+    void groupDelayApertureChanged(int points);
+
+    // Store the current data sweep as the memory trace.
+    void memoryStoreRequested();
+
+    // Trace math selected by the user (TraceMathOp, TraceHold values).
+    void traceMathChanged(int op, int hold);
+
+    // 2-port fixture (Touchstone) to de-embed, empty = off.
+    void fixtureRequested(const QString& path);
+
+    // Trend chart range (zoom / pan / follow), buckets = points that fit the width.
+    void trendRangeRequested(qint64 fromMs, qint64 toMs, int buckets);
+
+    // Sweep rate tuner: suggest points / IF bandwidth for targetHz with at least
+    // minPoints; autoApply applies the suggestion and keeps retuning.
+    void tuneRequested(double targetHz,
+                        int minPoints,
+                        bool autoApply);
 };
 
 Q_DECLARE_INTERFACE(IView, "Denis.Dennisov.TestTask/1.0")
@@ -0,0 +1,375 @@
+// Batch processor (Model) module.
+
+#include "Model/BatchProcessor.h"
+#include "Model/StreamingSweepParser.h"
+#include "Model/SweepParser.h"
+#include "Model/TouchstoneReader.h"
+
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <deque>
+#include <numeric>
+#include <vector>
+
+
+namespace {
+// Result of one file, written only by the worker that took it.
+struct FileResult
+{
+    QByteArray row;                 // CSV row.
+    bool ok = false;
+    bool hasVerdict = false;
+    LimitVerdict verdict;
+    int points = 0;
+    qint64 bytes = 0;
+    QVector<float> lo;
+    QVector<float> hi;
+};
+
+// One queue per worker: the owner takes from the front, an idle worker steals
+// from the back of another queue. Items are whole files, so a lock per queue
+// costs nothing next to the parsing.
+class WorkQueues
+{
+public:
+    explicit WorkQueues(int workers) : m_queues(size_t(workers)) {}
+
+    void push(int worker, int item) { m_queues[size_t(worker)].items.push_back(item); }
+
+    bool pop(int worker, int& item)
+    {
+        const int n = int(m_queues.size());
+        for (int k = 0; k < n; ++k) {
+            Queue& queue = m_queues[size_t((worker + k) % n)];
+            QMutexLocker locker(&queue.mutex);
+            if (queue.items.empty()) continue;
+            if (k == 0) {
+                item = queue.items.front();
+                queue.items.pop_front();
+            } else {
+                item = queue.items.back();
+                queue.items.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Queue
+    {
+        QMutex mutex;
+        std::deque<int> items;
+    };
+    std::vector<Queue> m_queues;
+};
+
+bool isMarker(const TrendChannel& channel)
+{
+    return channel.startHz == channel.stopHz;
+}
+
+QByteArray csvField(const QString& text)
+{
+    QByteArray field = text.toUtf8();
+    if (field.contains(',') || field.contains('"') || field.contains('\n')) {
+        field.replace("\"", "\"\"");
+        field = '"' + field + '"';
+    }
+    return field;
+}
+
+QByteArray csvNumber(double value)
+{
+    return std::isnan(value) ? QByteArray() : QByteArray::number(value, 'g', 10);
+}
+
+// Memory-mapped file -> sweep. Touchstone files by their .sNp extension, anything
+// else is a raw "re,im,..." reply placed on the --start / --stop grid.
+SweepPtr loadSweep(const QString& path, const BatchOptions& options, qint64* bytes, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return SweepPtr();
+    }
+    const qint64 size = file.size();
+    if (size <= 0 || size > INT_MAX) {
+        *error = size <= 0 ? "Empty file" : "File too large";
+        return SweepPtr();
+    }
+    uchar *map = file.map(0, size);
+    if (!map) {
+        *error = file.errorString();
+        return SweepPtr();
+    }
+    const char *data = reinterpret_cast<const char *>(map);
+    *bytes = size;
+
+    SweepPtr sweep;
+    const int ports = touchstonePorts(path);
+    if (ports > 0) {
+        TouchstoneNetwork network;
+        if (!parseTouchstone(data, size, ports, network, error)) {
+            file.unmap(map);
+            return SweepPtr();
+        }
+        if (options.row >= network.ports || options.col >= network.ports) {
+            *error = QString("No S%1%2 in a %3-port file").arg(options.row + 1).arg(options.col + 1).arg(network.ports);
+            file.unmap(map);
+            return SweepPtr();
+        }
+        // Sweeps are on a linear grid: log or segmented files would get wrong
+        // marker and limit frequencies (1 % of a step covers rounded numbers).
+        const QVector<double>& f = network.freqHz;
+        const double step = f.size() > 1 ? (f.last() - f.first()) / (f.size() - 1) : 0.0;
+        for (int i = 1; i < f.size() - 1; ++i) {
+            if (std::abs(f[i] - (f.first() + step * i)) > 0.01 * step) {
+                *error = QString("Frequencies are not uniform (point %1: %2 Hz)").arg(i + 1).arg(f[i], 0, 'f', 0);
+                file.unmap(map);
+                return SweepPtr();
+            }
+        }
+        QSharedPointer<SweepData> values(new SweepData);
+        const int k = network.index(options.row, options.col);
+        values->re = network.re[k];
+        values->im = network.im[k];
+        values->startHz = network.freqHz.first();
+        values->stopHz = network.freqHz.last();
+        sweep = values;
+    } else if (!(options.rawStopHz > options.rawStartHz)) {
+        // Raw replies carry no frequencies.
+        *error = "Raw reply without a grid (--start / --stop)";
+    } else {
+        // The reply's line end is not part of the last value.
+        qint64 end = size;
+        while (end > 0 && (data[end - 1] == '\n' || data[end - 1] == '\r' || data[end - 1] == ' ')) --end;
+
+        StreamingSweepParser parser;
+        parser.begin(int(size / 24));
+        parser.feed(data, int(end));
+        SweepPtr values = parser.finish();
+
+        VnaConfig cfg;
+        cfg.startFreq = options.rawStartHz / 1e9;
+        cfg.stopFreq = options.rawStopHz / 1e9;
+        cfg.points = values->size();
+        if (values->size() > 0) sweep = applySweepGrid(values, cfg, 0);
+        else *error = "No values";
+    }
+    file.unmap(map);
+    return sweep;
+}
+
+// Load, limit test (on Log Mag, as the client does) and marker values in the
+// selected format. The mask copy and the formatter belong to the worker.
+void processFile(const QString& path,
+                 const BatchOptions& options,
+                 LimitMask& mask,
+                 TraceFormatter& formats,
+                 FileResult& result)
+{
+    QString error;
+    const SweepPtr sweep = loadSweep(path, options, &result.bytes, &error);
+    result.row = csvField(path);
+    if (!sweep) {
+        result.row += ",ERROR,,,,,,," + csvField(error);
+        for (const TrendChannel& channel : options.markers) result.row += isMarker(channel) ? "," : ",,";
+        return;
+    }
+    result.ok = true;
+    result.points = sweep->size();
+    formats.setSweep(sweep);
+
+    if (!mask.isEmpty()) {
+        if (!mask.matchesGrid(sweep->startHz, sweep->stopHz, sweep->size())) {
+            mask.resample(sweep->startHz, sweep->stopHz, sweep->size());
+        }
+        result.verdict = mask.check(formats.values(TraceFormat::LogMag));
+        result.hasVerdict = true;
+    }
+
+    result.lo.resize(options.markers.size());
+    result.hi.resize(options.markers.size());
+    if (!options.markers.isEmpty()) {
+        trendChannelValues(*sweep, formats.values(options.format), options.markers,
+                           result.lo.data(), result.hi.data());
+    }
+
+    const double nan = std::nan("");
+    const LimitVerdict& v = result.verdict;
+    result.row += ',' + QByteArray(!result.hasVerdict ? "OK" : v.passed ? "PASS" : "FAIL")
+                + ',' + QByteArray::number(result.points)
+                + ',' + csvNumber(sweep->startHz)
+                + ',' + csvNumber(sweep->stopHz)
+                + ',' + csvNumber(result.hasVerdict ? v.worstMarginDb : nan)
+                + ',' + csvNumber(result.hasVerdict ? v.worstFreqHz / 1e6 : nan)
+                + ',' + (result.hasVerdict ? QByteArray::number(v.failedPoints) : QByteArray())
+                + ',';
+    for (int c = 0; c < options.markers.size(); ++c) {
+        result.row += ',' + csvNumber(result.lo[c]);
+        if (!isMarker(options.markers[c])) result.row += ',' + csvNumber(result.hi[c]);
+    }
+}
+
+void addStat(BatchSummary::Stats& stats, float value)
+{
+    if (std::isnan(value)) return;
+    stats.min = stats.count == 0 ? value : std::min(stats.min, double(value));
+    stats.max = stats.count == 0 ? value : std::max(stats.max, double(value));
+    stats.sum += value;
+    stats.sumSq += double(value) * value;
+    ++stats.count;
+}
+
+QString statsText(const BatchSummary::Stats& stats)
+{
+    if (stats.count == 0) return "no values";
+    const double mean = stats.sum / stats.count;
+    const double stddev = std::sqrt(std::max(stats.sumSq / stats.count - mean * mean, 0.0));
+    return QString("mean %1, stddev %2, min %3, max %4 (%5 files)")
+        .arg(mean, 0, 'g', 6).arg(stddev, 0, 'g', 4)
+        .arg(stats.min, 0, 'g', 6).arg(stats.max, 0, 'g', 6).arg(stats.count);
+}
+}
+
+
+// Files and directories (searched recursively).
+QStringList collectBatchFiles(const QStringList& paths)
+{
+    QStringList files;
+    for (const QString& path : paths) {
+        if (!QFileInfo(path).isDir()) {
+            files.append(path);
+            continue;
+        }
+        QStringList found;
+        QDirIterator it(path, { "*.txt", "*.dat", "*.csv", "*.s*p" }, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString file = it.next();
+            if (!file.endsWith("p", Qt::CaseInsensitive) || touchstonePorts(file) > 0) found.append(file);
+        }
+        found.sort();
+        files += found;
+    }
+    return files;
+}
+
+// Process the files on the work-stealing pool, then write the rows in order.
+BatchSummary runBatch(const QStringList& files, const BatchOptions& options, QTextStream& out)
+{
+    BatchSummary summary;
+    summary.files = files.size();
+    summary.threads = options.threads > 0 ? options.threads : QThread::idealThreadCount();
+    summary.threads = std::clamp(summary.threads, 1, std::max(int(files.size()), 1));
+
+    // Largest files first, dealt round-robin: the last items taken are the small ones.
+    QVector<qint64> sizes(files.size());
+    for (int i = 0; i < files.size(); ++i) sizes[i] = QFileInfo(files[i]).size();
+    QVector<int> order(files.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizes](int a, int b) { return sizes[a] > sizes[b]; });
+
+    WorkQueues queues(summary.threads);
+    for (int i = 0; i < order.size(); ++i) queues.push(i % summary.threads, order[i]);
+
+    QVector<FileResult> results(files.size());
+    FileResult *slots = results.data();
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<QThread *> workers;
+    for (int w = 0; w < summary.threads; ++w) {
+        workers.append(QThread::create([&files, &options, &queues, slots, w]() {
+            LimitMask mask = options.mask;      // Resampled per worker.
+            TraceFormatter formats;
+            formats.setGroupDelayAperture(options.aperture);
+            int item = 0;
+            while (queues.pop(w, item)) processFile(files[item], options, mask, formats, slots[item]);
+        }));
+        workers.last()->start();
+    }
+    for (QThread *worker : workers) {
+        worker->wait();
+        delete worker;
+    }
+    summary.elapsedNs = timer.nsecsElapsed();
+
+    // Header, rows and totals in input order.
+    QByteArray header = "file,status,points,start_hz,stop_hz,worst_margin_db,worst_freq_mhz,failed_points,error";
+    for (const TrendChannel& channel : options.markers) {
+        if (isMarker(channel)) header += ',' + csvField(channel.name);
+        else header += ',' + csvField(channel.name + " min") + ',' + csvField(channel.name + " max");
+    }
+    out << header << '\n';
+
+    summary.lo.resize(options.markers.size());
+    summary.hi.resize(options.markers.size());
+    bool haveWorst = false;
+    for (int i = 0; i < results.size(); ++i) {
+        const FileResult& result = results[i];
+        out << result.row << '\n';
+        summary.bytes += result.bytes;
+        if (!result.ok) {
+            ++summary.errors;
+            continue;
+        }
+        summary.points += result.points;
+        if (result.hasVerdict) {
+            result.verdict.passed ? ++summary.passed : ++summary.failed;
+            if (!haveWorst || result.verdict.worstMarginDb < summary.worstMarginDb) {
+                haveWorst = true;
+                summary.worstMarginDb = result.verdict.worstMarginDb;
+                summary.worstFile = files[i];
+            }
+        }
+        for (int c = 0; c < options.markers.size(); ++c) {
+            addStat(summary.lo[c], result.lo[c]);
+            addStat(summary.hi[c], result.hi[c]);
+        }
+    }
+    out.flush();
+    return summary;
+}
+
+// Totals, marker statistics and throughput.
+void printBatchSummary(const BatchSummary& summary, const BatchOptions& options, QTextStream& out)
+{
+    const double seconds = std::max(summary.elapsedNs, qint64(1)) / 1e9;
+
+    out << QString("Files: %1 (%2 error(s))").arg(summary.files).arg(summary.errors);
+    if (!options.mask.isEmpty()) {
+        out << QString(", PASS %1, FAIL %2").arg(summary.passed).arg(summary.failed);
+        if (!summary.worstFile.isEmpty()) {
+            out << QString(", worst margin %1 dB in %2").arg(summary.worstMarginDb, 0, 'f', 2).arg(summary.worstFile);
+        }
+    }
+    out << '\n';
+
+    const QString format = traceFormatName(options.format);
+    for (int c = 0; c < options.markers.size(); ++c) {
+        const TrendChannel& channel = options.markers[c];
+        if (isMarker(channel)) {
+            out << QString("%1 (%2): %3\n").arg(channel.name, format, statsText(summary.lo[c]));
+        } else {
+            out << QString("%1 (%2) min: %3\n").arg(channel.name, format, statsText(summary.lo[c]));
+            out << QString("%1 (%2) max: %3\n").arg(channel.name, format, statsText(summary.hi[c]));
+        }
+    }
+
+    out << QString("%1 thread(s), %2 s: %3 files/s, %4 points/s, %5 MB/s\n")
+               .arg(summary.threads)
+               .arg(seconds, 0, 'f', 3)
+               .arg(summary.files / seconds, 0, 'f', 1)
+               .arg(summary.points / seconds, 0, 'f', 0)
+               .arg(summary.bytes / seconds / 1e6, 0, 'f', 1);
+    out.flush();
+}
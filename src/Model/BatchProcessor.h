@@ -0,0 +1,69 @@
+// Batch processor (Model) module.
+// Reprocesses saved sweeps (raw :CALC:DATA:SDAT? replies, Touchstone files) on all cores.
+
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include "Model/LimitMask.h"
+#include "Model/TraceFormats.h"
+#include "Model/TrendStore.h"
+
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+
+// What is computed for every file.
+struct BatchOptions
+{
+    LimitMask mask;                     // Empty = no limit test.
+    TraceFormat format{TraceFormat::LogMag};    // Format of the marker values.
+    int aperture{1};                    // Group delay aperture, steps.
+    QVector<TrendChannel> markers;      // Markers / bands (min / max).
+    double rawStartHz{0.0};             // Grid of the raw replies (they carry none);
+    double rawStopHz{0.0};              // raw files are errors unless stop > start.
+    int row{0};                         // S-parameter of Touchstone files, S(row+1, col+1).
+    int col{0};
+    int threads{0};                     // 0 = one per core.
+};
+
+// Whole-run totals and per-marker statistics.
+struct BatchSummary
+{
+    struct Stats
+    {
+        qint64 count{0};
+        double sum{0.0};
+        double sumSq{0.0};
+        double min{0.0};
+        double max{0.0};
+    };
+
+    int files{0};
+    int errors{0};
+    int passed{0};
+    int failed{0};
+    qint64 points{0};
+    qint64 bytes{0};
+    qint64 elapsedNs{0};
+    int threads{0};
+    double worstMarginDb{0.0};
+    QString worstFile;
+    QVector<Stats> lo;                  // Per marker (min over a band).
+    QVector<Stats> hi;                  // Per marker (max over a band).
+};
+
+// Files and directories (searched recursively for *.txt, *.dat, *.csv, *.sNp).
+QStringList collectBatchFiles(const QStringList& paths);
+
+// Process the files: each one is memory-mapped, parsed with the client's parsers,
+// formatted, limit-tested and measured at the markers. Files are spread over a
+// work-stealing pool (largest first); one CSV row per file goes to `out` in input
+// order once all are done.
+BatchSummary runBatch(const QStringList& files, const BatchOptions& options, QTextStream& out);
+
+// Totals, per-marker mean / stddev / min / max and the throughput (files/s, points/s).
+void printBatchSummary(const BatchSummary& summary, const BatchOptions& options, QTextStream& out);
+
+#endif // BATCHPROCESSOR_H
@@ -0,0 +1,170 @@
+// Fixture de-embedding (Model) module.
+
+#include "Model/FixtureDeembedding.h"
+
+#include <QFileInfo>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+
+
+namespace {
+// Gd = (Gm - S11) / (S22*Gm - det) over points [from, to).
+void deembedRange(const SweepData& data,
+                  SweepData& out,
+                  const double *s11Re, const double *s11Im,
+                  const double *s22Re, const double *s22Im,
+                  const double *detRe, const double *detIm,
+                  int from, int to)
+{
+    const double *a = data.re.constData();
+    const double *b = data.im.constData();
+    double *re = out.re.data();
+    double *im = out.im.data();
+
+    for (int i = from; i < to; ++i) {
+        const double numRe = a[i] - s11Re[i];
+        const double numIm = b[i] - s11Im[i];
+        const double denRe = s22Re[i] * a[i] - s22Im[i] * b[i] - detRe[i];
+        const double denIm = s22Re[i] * b[i] + s22Im[i] * a[i] - detIm[i];
+        const double den = denRe * denRe + denIm * denIm;
+        re[i] = (numRe * denRe + numIm * denIm) / den;
+        im[i] = (numIm * denRe - numRe * denIm) / den;
+    }
+}
+}
+
+
+// Load a 2-port Touchstone file.
+bool FixtureDeembedding::load(const QString& path, QString* error)
+{
+    TouchstoneNetwork network;
+    if (!readTouchstone(path, network, error) || !setNetwork(network, error)) return false;
+    m_name = QFileInfo(path).fileName();
+    return true;
+}
+
+// Use an already read 2-port network.
+bool FixtureDeembedding::setNetwork(const TouchstoneNetwork& network, QString* error)
+{
+    if (network.ports != 2 || network.points() == 0) {
+        if (error) *error = QString("A fixture must be a 2-port network (got %1 port(s))").arg(network.ports);
+        return false;
+    }
+    m_network = network;
+    m_name.clear();
+    m_gridPoints = -1;
+    return true;
+}
+
+void FixtureDeembedding::clear()
+{
+    m_network = TouchstoneNetwork();
+    m_name.clear();
+    m_gridPoints = -1;
+}
+
+// De-embedded sweep.
+SweepPtr FixtureDeembedding::apply(const SweepPtr& data, bool* outOfRange)
+{
+    if (!data || data->size() == 0 || isEmpty()) return data;
+
+    prepare(*data);
+    if (outOfRange) *outOfRange = m_gridOutOfRange;
+
+    const int n = data->size();
+    QSharedPointer<SweepData> out(new SweepData(*data));
+    out->re.detach();
+    out->im.detach();
+
+    const double *s11Re = m_s11Re.constData();
+    const double *s11Im = m_s11Im.constData();
+    const double *s22Re = m_s22Re.constData();
+    const double *s22Im = m_s22Im.constData();
+    const double *detRe = m_detRe.constData();
+    const double *detIm = m_detIm.constData();
+
+    const int chunks = n < kParallelPoints
+                           ? 1
+                           : std::min(QThread::idealThreadCount(), n / (kParallelPoints / 2));
+    if (chunks <= 1) {
+        deembedRange(*data, *out, s11Re, s11Im, s22Re, s22Im, detRe, detIm, 0, n);
+        return out;
+    }
+
+    // Chunks 1.. on the pool, chunk 0 on this thread.
+    QSemaphore done;
+    const int size = (n + chunks - 1) / chunks;
+    const SweepData& in = *data;
+    SweepData& result = *out;
+    for (int c = 1; c < chunks; ++c) {
+        const int from = c * size;
+        const int to = std::min(n, from + size);
+        QThreadPool::globalInstance()->start([&, from, to]() {
+            deembedRange(in, result, s11Re, s11Im, s22Re, s22Im, detRe, detIm, from, to);
+            done.release();
+        });
+    }
+    deembedRange(in, result, s11Re, s11Im, s22Re, s22Im, detRe, detIm, 0, std::min(n, size));
+    done.acquire(chunks - 1);
+    return out;
+}
+
+// Fixture terms on the sweep grid: linear re / im interpolation of S11, S22,
+// S12 and S21 (one pass, the fixture frequencies need not be uniform), then det.
+void FixtureDeembedding::prepare(const SweepData& data)
+{
+    const int n = data.size();
+    if (m_gridPoints == n && m_gridStartHz == data.startHz && m_gridStopHz == data.stopHz) return;
+
+    const TouchstoneNetwork& net = m_network;
+    const QVector<double>& f = net.freqHz;
+    const int m = net.points();
+    const int k11 = net.index(0, 0);
+    const int k12 = net.index(0, 1);
+    const int k21 = net.index(1, 0);
+    const int k22 = net.index(1, 1);
+
+    m_s11Re.resize(n);
+    m_s11Im.resize(n);
+    m_s22Re.resize(n);
+    m_s22Im.resize(n);
+    m_detRe.resize(n);
+    m_detIm.resize(n);
+
+    const double tolerance = std::max(data.stepHz(), 1.0) * 1e-6;
+    m_gridOutOfRange = data.startHz < f.first() - tolerance || data.stopHz > f.last() + tolerance;
+
+    auto at = [&](const QVector<double>& v, int j, double t) {
+        return t == 0.0 ? v[j] : v[j] + (v[j + 1] - v[j]) * t;
+    };
+
+    int j = 0;
+    for (int i = 0; i < n; ++i) {
+        const double hz = std::clamp(data.freqHz(i), f.first(), f.last());
+        while (j < m - 2 && f[j + 1] < hz) ++j;
+        const double span = m > 1 ? f[j + 1] - f[j] : 0.0;
+        const double t = span > 0.0 ? std::clamp((hz - f[j]) / span, 0.0, 1.0) : 0.0;
+
+        const double s11Re = at(net.re[k11], j, t);
+        const double s11Im = at(net.im[k11], j, t);
+        const double s12Re = at(net.re[k12], j, t);
+        const double s12Im = at(net.im[k12], j, t);
+        const double s21Re = at(net.re[k21], j, t);
+        const double s21Im = at(net.im[k21], j, t);
+        const double s22Re = at(net.re[k22], j, t);
+        const double s22Im = at(net.im[k22], j, t);
+
+        m_s11Re[i] = s11Re;
+        m_s11Im[i] = s11Im;
+        m_s22Re[i] = s22Re;
+        m_s22Im[i] = s22Im;
+        m_detRe[i] = (s11Re * s22Re - s11Im * s22Im) - (s12Re * s21Re - s12Im * s21Im);
+        m_detIm[i] = (s11Re * s22Im + s11Im * s22Re) - (s12Re * s21Im + s12Im * s21Re);
+    }
+
+    m_gridStartHz = data.startHz;
+    m_gridStopHz = data.stopHz;
+    m_gridPoints = n;
+}
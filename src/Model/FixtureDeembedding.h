@@ -0,0 +1,68 @@
+// Fixture de-embedding (Model) module.
+// Removes a known 2-port fixture (Touchstone file) from every measured sweep.
+
+#ifndef FIXTUREDEEMBEDDING_H
+#define FIXTUREDEEMBEDDING_H
+
+#include "Model/SweepData.h"
+#include "Model/TouchstoneReader.h"
+
+#include <QVector>
+#include <QString>
+
+
+// The fixture sits between the analyzer port (fixture port 1) and the DUT
+// (fixture port 2). With the T-parameters of the fixture
+//
+//     T = 1/S21 * | -det  S11 |      det = S11*S22 - S12*S21
+//                 | -S22   1  |
+//
+// the waves at the DUT are T^-1 applied to the measured waves, which for the
+// reflection sweep is Gd = (Gm - S11) / (S22*Gm - det) at every frequency.
+//
+// The fixture is interpolated (linear re / im) onto the sweep grid once per grid
+// and kept as separate re / im arrays of S11, S22 and det, so continuous sweeps
+// only pay for the branch-free complex division. Large sweeps are split over
+// the global thread pool.
+class FixtureDeembedding
+{
+public:
+    FixtureDeembedding() = default;
+
+    // Load a 2-port Touchstone file. The previous fixture is kept on failure.
+    bool load(const QString& path, QString* error = nullptr);
+    // Use an already read 2-port network.
+    bool setNetwork(const TouchstoneNetwork& network, QString* error = nullptr);
+    void clear();
+
+    bool isEmpty() const { return m_network.points() == 0; }
+    QString name() const { return m_name; }
+
+    // De-embedded sweep (a new sweep; the input when no fixture is loaded).
+    // outOfRange is set when the grid reaches outside the fixture frequencies:
+    // the edge values are used there.
+    SweepPtr apply(const SweepPtr& data, bool* outOfRange = nullptr);
+
+    // Sweeps at least this long are split over the thread pool.
+    static constexpr int kParallelPoints = 16384;
+
+private:
+    // Fixture terms on the sweep grid (cached per grid).
+    void prepare(const SweepData& data);
+
+    TouchstoneNetwork m_network;
+    QString m_name;
+
+    QVector<double> m_s11Re;            // On the current grid.
+    QVector<double> m_s11Im;
+    QVector<double> m_s22Re;
+    QVector<double> m_s22Im;
+    QVector<double> m_detRe;
+    QVector<double> m_detIm;
+    double m_gridStartHz = 0.0;
+    double m_gridStopHz = 0.0;
+    int m_gridPoints = -1;              // -1 = not prepared.
+    bool m_gridOutOfRange = false;
+};
+
+#endif // FIXTUREDEEMBEDDING_H
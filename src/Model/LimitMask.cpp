@@ -0,0 +1,147 @@
+// Limit mask (Model) module.
+// Segments are resampled once per frequency grid, so each sweep check is a single
+// linear pass over the points without branches in the loop body.
+
+#include "Model/LimitMask.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+// Load segments from a text file. Empty lines and lines starting with '#' are skipped.
+bool LimitMask::loadFromFile(const QString& path, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    QVector<LimitSegment> segments;
+    QTextStream in(&file);
+    int lineNumber = 0;
+
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        const QStringList parts = line.split(QRegularExpression("[\\s,;]+"), Qt::SkipEmptyParts);
+        bool ok[4] = {false, false, false, false};
+        LimitSegment seg;
+
+        if (parts.size() == 5) {
+            const QString type = parts[0].toUpper();
+            seg.type = (type == "LOWER") ? LimitSegment::Type::Lower : LimitSegment::Type::Upper;
+            seg.startHz = parts[1].toDouble(&ok[0]) * 1e9;
+            seg.stopHz = parts[2].toDouble(&ok[1]) * 1e9;
+            seg.startDb = parts[3].toDouble(&ok[2]);
+            seg.stopDb = parts[4].toDouble(&ok[3]);
+
+            if (type != "UPPER" && type != "LOWER") ok[0] = false;
+        }
+
+        if (!ok[0] || !ok[1] || !ok[2] || !ok[3] || seg.stopHz < seg.startHz) {
+            if (error) *error = QString("Invalid limit line %1: %2").arg(lineNumber).arg(line);
+            return false;
+        }
+        segments.append(seg);
+    }
+
+    m_segments = segments;
+    m_gridPoints = 0;           // Force resampling on the next sweep.
+    return true;
+}
+
+// Remove all segments.
+void LimitMask::clear()
+{
+    m_segments.clear();
+    m_upper.clear();
+    m_lower.clear();
+    m_gridPoints = 0;
+}
+
+// Check if the mask was already resampled onto this frequency grid.
+bool LimitMask::matchesGrid(double startHz, double stopHz, int points) const
+{
+    return m_gridPoints == points && m_gridStartHz == startHz && m_gridStopHz == stopHz;
+}
+
+// Resample segments onto the active frequency grid.
+// Overlapping upper segments keep the lowest value, lower segments the highest.
+void LimitMask::resample(double startHz, double stopHz, int points)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    const int n = std::max(points, 0);
+
+    m_upper.fill(inf, n);
+    m_lower.fill(-inf, n);
+    m_gridStartHz = startHz;
+    m_gridStopHz = stopHz;
+    m_gridPoints = points;
+
+    if (n == 0) return;
+    const double step = n > 1 ? (stopHz - startHz) / (n - 1) : 0.0;
+
+    for (const LimitSegment& seg : m_segments) {
+        // Index range covered by the segment.
+        int first = 0;
+        int last = n - 1;
+        if (step > 0.0) {
+            first = std::max(0, int(std::ceil((seg.startHz - startHz) / step - 1e-9)));
+            last = std::min(n - 1, int(std::floor((seg.stopHz - startHz) / step + 1e-9)));
+        } else if (startHz < seg.startHz || startHz > seg.stopHz) {
+            continue;
+        }
+
+        const double span = seg.stopHz - seg.startHz;
+        for (int i = first; i <= last; ++i) {
+            const double freqHz = startHz + step * i;
+            const double t = span > 0.0 ? (freqHz - seg.startHz) / span : 0.0;
+            const double level = seg.startDb + (seg.stopDb - seg.startDb) * t;
+
+            if (seg.type == LimitSegment::Type::Upper)
+                m_upper[i] = std::min(m_upper[i], level);
+            else
+                m_lower[i] = std::max(m_lower[i], level);
+        }
+    }
+}
+
+// Check the sweep against the resampled mask in one branch-free pass.
+LimitVerdict LimitMask::check(const QVector<double>& magDb) const
+{
+    LimitVerdict verdict;
+    const int n = std::min<int>(magDb.size(), m_upper.size());
+    if (n == 0) return verdict;
+
+    const double* mag = magDb.constData();
+    const double* upper = m_upper.constData();
+    const double* lower = m_lower.constData();
+
+    double worst = std::numeric_limits<double>::infinity();
+    int worstIndex = 0;
+    int failed = 0;
+
+    for (int i = 0; i < n; ++i) {
+        const double y = mag[i];
+        const double margin = std::min(upper[i] - y, y - lower[i]);
+        failed += margin < 0.0;
+        worstIndex = margin < worst ? i : worstIndex;
+        worst = std::min(margin, worst);
+    }
+
+    const double step = m_gridPoints > 1 ? (m_gridStopHz - m_gridStartHz) / (m_gridPoints - 1) : 0.0;
+    verdict.passed = failed == 0;
+    verdict.failedPoints = failed;
+    verdict.worstMarginDb = std::isfinite(worst) ? worst : 0.0;
+    verdict.worstFreqHz = m_gridStartHz + step * worstIndex;
+    return verdict;
+}
@@ -0,0 +1,68 @@
+// Limit mask (Model) module.
+// Stores piecewise-linear upper/lower limit lines and checks sweeps against them.
+
+#ifndef LIMITMASK_H
+#define LIMITMASK_H
+
+#include <QString>
+#include <QVector>
+
+
+// One limit line segment, frequencies in Hz, levels in dB.
+struct LimitSegment
+{
+    enum class Type { Upper, Lower };
+
+    Type type{Type::Upper};
+    double startHz{0.0};
+    double stopHz{0.0};
+    double startDb{0.0};
+    double stopDb{0.0};
+};
+
+// Result of checking one sweep against the mask.
+struct LimitVerdict
+{
+    bool passed{true};
+    double worstMarginDb{0.0};      // Smallest (upper - y, y - lower), negative = fail.
+    double worstFreqHz{0.0};        // Frequency of the worst margin.
+    int failedPoints{0};            // Number of points outside the mask.
+};
+
+
+class LimitMask
+{
+public:
+    LimitMask() = default;
+
+    // Load segments from a text file. Line format (frequencies in GHz):
+    // UPPER|LOWER <startGHz> <stopGHz> <startDb> <stopDb>
+    bool loadFromFile(const QString& path, QString* error = nullptr);
+
+    // Remove all segments.
+    void clear();
+
+    bool isEmpty() const { return m_segments.isEmpty(); }
+
+    // Check if the mask was already resampled onto this frequency grid.
+    bool matchesGrid(double startHz, double stopHz, int points) const;
+
+    // Resample segments onto the active frequency grid (once per grid change).
+    void resample(double startHz, double stopHz, int points);
+
+    // Check the sweep magnitude (dB) against the resampled mask.
+    LimitVerdict check(const QVector<double>& magDb) const;
+
+private:
+    QVector<LimitSegment> m_segments;
+
+    // Resampled limits, +/-inf where no segment covers the point.
+    QVector<double> m_upper;
+    QVector<double> m_lower;
+
+    double m_gridStartHz = 0.0;
+    double m_gridStopHz = 0.0;
+    int m_gridPoints = 0;
+};
+
+#endif // LIMITMASK_H
@@ -0,0 +1,173 @@
+// Metrics (Model) module.
+
+#include "Model/Metrics.h"
+
+#include <QtAlgorithms>
+#include <QMutexLocker>
+#include <algorithm>
+#include <cstdio>
+#include <initializer_list>
+
+
+// Bucket of a value: values below 16 map directly, larger values keep
+// their 4 bits after the most significant one.
+int LatencyHistogram::bucketIndex(quint64 v)
+{
+    if (v < quint64(kSubBuckets)) return int(v);
+    const int msb = 63 - qCountLeadingZeroBits(v);
+    const int shift = msb - kSubBits;
+    return (shift + 1) * kSubBuckets + int((v >> shift) - kSubBuckets);
+}
+
+// Largest value that falls into the bucket.
+quint64 LatencyHistogram::bucketUpper(int index)
+{
+    if (index < kSubBuckets) return quint64(index);
+    const int shift = index / kSubBuckets - 1;
+    const quint64 sub = quint64(index % kSubBuckets);
+    return ((kSubBuckets + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 ns)
+{
+    const quint64 v = ns > 0 ? quint64(ns) : 0;
+    m_buckets[bucketIndex(v)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(v, std::memory_order_relaxed);
+}
+
+// Value at quantile q, ns.
+qint64 LatencyHistogram::quantile(double q) const
+{
+    const quint64 total = count();
+    if (total == 0) return 0;
+
+    const quint64 target = std::max<quint64>(1, quint64(std::clamp(q, 0.0, 1.0) * total + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) return qint64(bucketUpper(i));
+    }
+    return qint64(bucketUpper(kBucketCount - 1));
+}
+
+Metrics& Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+// Per-stage processing time, created on first use.
+LatencyHistogram& Metrics::stageNs(const QString& stage)
+{
+    QMutexLocker locker(&m_stageMutex);
+    std::unique_ptr<LatencyHistogram>& h = m_stages[stage];
+    if (!h) h.reset(new LatencyHistogram);
+    return *h;
+}
+
+namespace {
+void printStartupPhase(const QByteArray& phase, qint64 ns, qint64 previousNs)
+{
+    std::fprintf(stderr, "startup: %9.1f ms  (+%8.1f ms)  %s\n",
+                 ns / 1e6, (ns - previousNs) / 1e6, phase.constData());
+    std::fflush(stderr);
+}
+}
+
+// End of a startup phase.
+void Metrics::markStartup(const char* phase)
+{
+    const qint64 ns = m_startupClock.nsecsElapsed();
+    QMutexLocker locker(&m_startupMutex);
+    for (const auto& entry : m_startup) {
+        if (entry.first == phase) return;
+    }
+    const qint64 previousNs = m_startup.empty() ? 0 : m_startup.back().second;
+    m_startup.emplace_back(QByteArray(phase), ns);
+    if (m_startupPrint.load(std::memory_order_relaxed)) printStartupPhase(m_startup.back().first, ns, previousNs);
+}
+
+// Print the phases reached so far, then each new one.
+void Metrics::setStartupPrint(bool enabled)
+{
+    QMutexLocker locker(&m_startupMutex);
+    if (enabled && !m_startupPrint.load(std::memory_order_relaxed)) {
+        qint64 previousNs = 0;
+        for (const auto& entry : m_startup) {
+            printStartupPhase(entry.first, entry.second, previousNs);
+            previousNs = entry.second;
+        }
+    }
+    m_startupPrint.store(enabled, std::memory_order_relaxed);
+}
+
+namespace {
+void appendCounter(QByteArray& out, const char* name, const char* help, const MetricCounter& c)
+{
+    out += QByteArray("# HELP ") + name + ' ' + help + "\n# TYPE " + name + " counter\n";
+    out += QByteArray(name) + ' ' + QByteArray::number(c.value()) + '\n';
+}
+
+// Histograms are exposed as summaries (quantiles in seconds).
+void appendSummary(QByteArray& out, const char* name, const char* help, const LatencyHistogram& h)
+{
+    out += QByteArray("# HELP ") + name + ' ' + help + "\n# TYPE " + name + " summary\n";
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        out += QByteArray(name) + "{quantile=\"" + QByteArray::number(q) + "\"} "
+             + QByteArray::number(h.quantile(q) / 1e9, 'g', 6) + '\n';
+    }
+    out += QByteArray(name) + "_sum " + QByteArray::number(h.sumNs() / 1e9, 'g', 9) + '\n';
+    out += QByteArray(name) + "_count " + QByteArray::number(h.count()) + '\n';
+}
+}
+
+// Prometheus text exposition format.
+QByteArray Metrics::prometheusText() const
+{
+    QByteArray out;
+    out.reserve(4096);
+    appendCounter(out, "s2vna_socket_read_bytes_total", "Bytes read from the instrument socket.", bytesRead);
+    appendCounter(out, "s2vna_socket_written_bytes_total", "Bytes written to the instrument socket.", bytesWritten);
+    appendCounter(out, "s2vna_sweeps_received_total", "Sweeps received by the worker.", sweepsReceived);
+    appendCounter(out, "s2vna_connect_attempts_total", "Connection attempts to the instrument.", connectAttempts);
+    appendCounter(out, "s2vna_disconnects_total", "Lost instrument connections.", disconnects);
+    appendCounter(out, "s2vna_reconnects_total", "Connections after the first successful one.", reconnects);
+    appendCounter(out, "s2vna_frames_processed_total", "Frames processed by the presenter.", framesProcessed);
+    appendCounter(out, "s2vna_frames_displayed_total", "Frames drawn by the view.", framesDisplayed);
+    appendCounter(out, "s2vna_frames_dropped_total", "Frames replaced before being drawn.", framesDropped);
+    appendSummary(out, "s2vna_sweep_interval_seconds", "Time between received sweeps.", sweepIntervalNs);
+    appendSummary(out, "s2vna_parse_seconds", "Sweep parse time.", parseNs);
+    appendSummary(out, "s2vna_process_seconds", "Sweep processing time.", processNs);
+    appendSummary(out, "s2vna_render_seconds", "Chart render time.", renderNs);
+    appendCounter(out, "s2vna_pipeline_dropped_total", "Sweeps dropped before the first processing stage.", pipelineDropped);
+
+    {
+        QMutexLocker locker(&m_startupMutex);
+        if (!m_startup.empty()) {
+            out += "# HELP s2vna_startup_seconds Time from main() to the end of each startup phase.\n"
+                   "# TYPE s2vna_startup_seconds gauge\n";
+        }
+        for (const auto& entry : m_startup) {
+            out += "s2vna_startup_seconds{phase=\"" + entry.first + "\"} "
+                 + QByteArray::number(entry.second / 1e9, 'g', 6) + '\n';
+        }
+    }
+
+    QMutexLocker locker(&m_stageMutex);
+    if (!m_stages.empty()) {
+        out += "# HELP s2vna_stage_seconds Processing time per pipeline stage.\n"
+               "# TYPE s2vna_stage_seconds summary\n";
+    }
+    for (const auto& entry : m_stages) {
+        const QByteArray label = "stage=\"" + entry.first.toUtf8() + "\"";
+        const LatencyHistogram& h = *entry.second;
+        for (double q : {0.5, 0.9, 0.99, 0.999}) {
+            out += "s2vna_stage_seconds{" + label + ",quantile=\"" + QByteArray::number(q) + "\"} "
+                 + QByteArray::number(h.quantile(q) / 1e9, 'g', 6) + '\n';
+        }
+        out += "s2vna_stage_seconds_sum{" + label + "} " + QByteArray::number(h.sumNs() / 1e9, 'g', 9) + '\n';
+        out += "s2vna_stage_seconds_count{" + label + "} " + QByteArray::number(h.count()) + '\n';
+    }
+    return out;
+}
@@ -0,0 +1,127 @@
+// Metrics (Model) module.
+// Lock-free counters and latency histograms shared by all pipeline stages.
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+
+// Monotonic counter, relaxed atomic increment only.
+class MetricCounter
+{
+public:
+    void add(quint64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+
+// HDR-style log-linear histogram of nanosecond latencies.
+// Each power of two is split into 16 linear sub-buckets (~6% relative error),
+// recording is one relaxed atomic increment.
+class LatencyHistogram
+{
+public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kBucketCount = (64 - kSubBits + 1) * kSubBuckets;
+
+    void record(qint64 ns);
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    quint64 sumNs() const { return m_sum.load(std::memory_order_relaxed); }
+
+    // Value at quantile q (0..1), ns. Upper bound of the bucket.
+    qint64 quantile(double q) const;
+
+private:
+    static int bucketIndex(quint64 v);
+    static quint64 bucketUpper(int index);
+
+    std::array<std::atomic<quint64>, kBucketCount> m_buckets{};
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sum{0};
+};
+
+
+// Records the elapsed time of a scope into a histogram.
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram) : m_histogram(histogram) { m_timer.start(); }
+    ~ScopedLatency() { m_histogram.record(m_timer.nsecsElapsed()); }
+
+private:
+    LatencyHistogram& m_histogram;
+    QElapsedTimer m_timer;
+};
+
+
+// Process-wide metrics registry.
+struct Metrics
+{
+    static Metrics& instance();
+
+    // ======== ScpiClient ========
+    MetricCounter bytesRead;
+    MetricCounter bytesWritten;
+
+    // ======== VnaWorker ========
+    MetricCounter sweepsReceived;
+    MetricCounter connectAttempts;
+    MetricCounter disconnects;
+    MetricCounter reconnects;               // Connections after the first successful one.
+    LatencyHistogram sweepIntervalNs;       // Time between received sweeps.
+
+    // ======== Presenter ========
+    LatencyHistogram parseNs;
+    LatencyHistogram processNs;             // Parse + formats + limit test.
+    MetricCounter framesProcessed;
+    MetricCounter framesDisplayed;
+    MetricCounter framesDropped;
+
+    // ======== View ========
+    LatencyHistogram renderNs;
+
+    // ======== Processing pipeline ========
+    MetricCounter pipelineDropped;
+
+    // ======== Startup ========
+    // Time since main() at which a startup phase ended; only the first mark of a
+    // phase counts. With printing on (--profile-startup) every phase goes to
+    // stderr as it is reached.
+    void markStartup(const char* phase);
+    // Enabling prints the phases reached so far.
+    void setStartupPrint(bool enabled);
+
+    // Per-stage processing time, created on first use (reference stays valid).
+    LatencyHistogram& stageNs(const QString& stage);
+
+    // Prometheus text exposition format (version 0.0.4).
+    QByteArray prometheusText() const;
+
+private:
+    Metrics() { m_startupClock.start(); }
+
+    mutable QMutex m_stageMutex;
+    std::map<QString, std::unique_ptr<LatencyHistogram>> m_stages;
+
+    mutable QMutex m_startupMutex;
+    QElapsedTimer m_startupClock;                           // Started by the first instance() call.
+    std::vector<std::pair<QByteArray, qint64>> m_startup;   // Phase, ns (in reaching order).
+    std::atomic<bool> m_startupPrint{false};
+};
+
+#endif // METRICS_H
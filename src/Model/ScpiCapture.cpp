@@ -0,0 +1,118 @@
+// SCPI traffic capture (Model) module.
+
+#include "Model/ScpiCapture.h"
+
+#include <cstring>
+
+
+namespace {
+const char kMagic[8] = {'S', '2', 'V', 'N', 'A', 'C', 'A', 'P'};
+const quint32 kVersion = 1;
+
+// LEB128 unsigned varint.
+void appendVarint(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+bool readVarint(const uchar*& p, const uchar* end, quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uchar byte = *p++;
+        value |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+}
+
+ScpiCaptureWriter::~ScpiCaptureWriter()
+{
+    close();
+}
+
+// Create the capture file and start the clock.
+bool ScpiCaptureWriter::open(const QString& path, QString* error)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = m_file.errorString();
+        return false;
+    }
+
+    m_file.write(kMagic, sizeof(kMagic));
+    const quint32 version = kVersion;
+    m_file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+
+    m_clock.start();
+    m_lastNs = 0;
+    return true;
+}
+
+void ScpiCaptureWriter::close()
+{
+    if (m_file.isOpen()) {
+        m_file.flush();
+        m_file.close();
+    }
+}
+
+// Log one chunk. Times are stored as deltas to keep the records small.
+void ScpiCaptureWriter::record(ScpiCaptureRecord::Direction direction, const QByteArray& data)
+{
+    if (!m_file.isOpen()) return;
+
+    const qint64 now = m_clock.nsecsElapsed();
+    m_buffer.clear();
+    m_buffer.append(char(direction));
+    appendVarint(m_buffer, quint64(now - m_lastNs));
+    appendVarint(m_buffer, quint64(data.size()));
+    m_lastNs = now;
+
+    m_file.write(m_buffer);
+    m_file.write(data);
+}
+
+// Loads all records of a capture file.
+bool readScpiCapture(const QString& path, QVector<ScpiCaptureRecord>& records, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    const QByteArray content = file.readAll();
+    const int headerSize = int(sizeof(kMagic) + sizeof(quint32));
+    if (content.size() < headerSize || memcmp(content.constData(), kMagic, sizeof(kMagic)) != 0) {
+        if (error) *error = "Not a SCPI capture file";
+        return false;
+    }
+
+    records.clear();
+    const uchar* p = reinterpret_cast<const uchar*>(content.constData()) + headerSize;
+    const uchar* end = reinterpret_cast<const uchar*>(content.constData()) + content.size();
+    qint64 timeNs = 0;
+
+    while (p < end) {
+        ScpiCaptureRecord rec;
+        quint64 delta = 0, length = 0;
+        rec.direction = ScpiCaptureRecord::Direction(*p++);
+        if (!readVarint(p, end, delta) || !readVarint(p, end, length) || quint64(end - p) < length) {
+            if (error) *error = "Truncated SCPI capture file";
+            return false;
+        }
+        timeNs += qint64(delta);
+        rec.timeNs = timeNs;
+        rec.data = QByteArray(reinterpret_cast<const char*>(p), int(length));
+        p += length;
+        records.append(rec);
+    }
+    return true;
+}
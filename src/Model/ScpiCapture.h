@@ -0,0 +1,61 @@
+// SCPI traffic capture (Model) module.
+// Compact binary log of every write and read chunk with a monotonic timestamp.
+//
+// File layout: "S2VNACAP" magic, u32 version, then records:
+//   u8 direction, varint delta time (ns), varint length, payload bytes.
+
+#ifndef SCPICAPTURE_H
+#define SCPICAPTURE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+
+// Transport selection for ScpiClient.
+struct ScpiTransportOptions
+{
+    QString capturePath;            // Log the traffic to this file (empty = off).
+    QString replayPath;             // Replay this file instead of the socket (empty = off).
+    bool replayRealTime{true};      // Replay at the recorded speed, else as fast as possible.
+};
+
+// One captured chunk.
+struct ScpiCaptureRecord
+{
+    enum class Direction : quint8 { Write = 0, Read = 1 };
+
+    Direction direction{Direction::Read};
+    qint64 timeNs{0};               // Monotonic time since the capture start.
+    QByteArray data;
+};
+
+
+// Appends records to a capture file.
+class ScpiCaptureWriter
+{
+public:
+    ScpiCaptureWriter() = default;
+    ~ScpiCaptureWriter();
+
+    bool open(const QString& path, QString* error = nullptr);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Log one chunk exactly as it was written to / read from the socket.
+    void record(ScpiCaptureRecord::Direction direction, const QByteArray& data);
+
+private:
+    QFile m_file;
+    QElapsedTimer m_clock;
+    qint64 m_lastNs = 0;
+    QByteArray m_buffer;            // Reused record encoding buffer.
+};
+
+
+// Loads all records of a capture file.
+bool readScpiCapture(const QString& path, QVector<ScpiCaptureRecord>& records, QString* error = nullptr);
+
+#endif // SCPICAPTURE_H
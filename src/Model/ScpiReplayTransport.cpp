@@ -0,0 +1,82 @@
+// SCPI replay transport (Model) module.
+
+#include "Model/ScpiReplayTransport.h"
+
+
+ScpiReplayTransport::ScpiReplayTransport(QObject *parent)
+    : QObject(parent)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &ScpiReplayTransport::pump);
+}
+
+// Load the capture file.
+bool ScpiReplayTransport::open(const QString& path, bool realTime, QString* error)
+{
+    stop();
+    m_realTime = realTime;
+    return readScpiCapture(path, m_records, error);
+}
+
+// Start the replay from the first record.
+void ScpiReplayTransport::start()
+{
+    m_pos = 0;
+    m_writesIssued = 0;
+    m_running = true;
+    m_clock.start();
+    m_anchorCaptureNs = 0;
+    m_anchorWallNs = 0;
+    QTimer::singleShot(0, this, &ScpiReplayTransport::pump);
+}
+
+void ScpiReplayTransport::stop()
+{
+    m_running = false;
+    m_timer->stop();
+}
+
+// The client wrote a command: release the reads that were waiting for it.
+void ScpiReplayTransport::notifyWrite(const QByteArray&)
+{
+    if (!m_running) return;
+    ++m_writesIssued;
+    pump();
+}
+
+// Release all records that are due.
+void ScpiReplayTransport::pump()
+{
+    while (m_running && m_pos < m_records.size()) {
+        const ScpiCaptureRecord& rec = m_records[m_pos];
+
+        if (rec.direction == ScpiCaptureRecord::Direction::Write) {
+            // Wait until the client has issued the recorded write.
+            if (m_writesIssued == 0) return;
+            --m_writesIssued;
+            m_anchorCaptureNs = rec.timeNs;
+            m_anchorWallNs = m_clock.nsecsElapsed();
+            ++m_pos;
+            continue;
+        }
+
+        if (m_realTime) {
+            const qint64 dueNs = m_anchorWallNs + (rec.timeNs - m_anchorCaptureNs);
+            const qint64 waitNs = dueNs - m_clock.nsecsElapsed();
+            if (waitNs > 0) {
+                m_timer->start(int(waitNs / 1000000));
+                return;
+            }
+        }
+
+        ++m_pos;
+        emit chunkReady(rec.data);
+    }
+
+    if (m_running && m_pos >= m_records.size()) {
+        m_running = false;
+        emit finished();
+    }
+}
@@ -0,0 +1,63 @@
+// SCPI replay transport (Model) module.
+// Feeds a capture file back into ScpiClient instead of QTcpSocket.
+
+#ifndef SCPIREPLAYTRANSPORT_H
+#define SCPIREPLAYTRANSPORT_H
+
+#include "Model/ScpiCapture.h"
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+
+
+// Read chunks are released in the recorded order with the recorded boundaries.
+// A read that followed a write in the capture waits until the client has issued
+// that write, so the replay stays deterministic whatever the client timing is.
+// !! Runs in the ScpiClient thread. !!
+class ScpiReplayTransport : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ScpiReplayTransport(QObject *parent = nullptr);
+    ~ScpiReplayTransport() override = default;
+
+    // Load the capture file.
+    bool open(const QString& path, bool realTime, QString* error = nullptr);
+
+    // Start / stop the replay (like connect / abort of the socket).
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // The client wrote a command.
+    void notifyWrite(const QByteArray& data);
+
+signals:
+    // Read chunk exactly as it arrived from the instrument.
+    void chunkReady(const QByteArray& data);
+
+    // All records were replayed.
+    void finished();
+
+private slots:
+    // Release all records that are due.
+    void pump();
+
+private:
+    QVector<ScpiCaptureRecord> m_records;
+    int m_pos = 0;
+    int m_writesIssued = 0;         // Client writes not yet matched with the capture.
+    bool m_running = false;
+    bool m_realTime = true;
+
+    // Real-time pacing: capture time and wall time of the last matched write.
+    qint64 m_anchorCaptureNs = 0;
+    qint64 m_anchorWallNs = 0;
+    QElapsedTimer m_clock;
+    QTimer *m_timer = nullptr;
+};
+
+#endif // SCPIREPLAYTRANSPORT_H
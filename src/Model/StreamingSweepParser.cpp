@@ -0,0 +1,102 @@
+// Streaming sweep parser (Model) module.
+
+#include "Model/StreamingSweepParser.h"
+
+#include <charconv>
+#include <cstring>
+
+
+// Start a new sweep; expectedPoints only sizes the buffers.
+void StreamingSweepParser::begin(int expectedPoints)
+{
+    m_expected = expectedPoints > 0 ? expectedPoints : 0;
+    m_sweep.reset(new SweepData);
+    m_sweep->re.reserve(m_expected);
+    m_sweep->im.reserve(m_expected);
+    m_carry.clear();
+    m_haveRe = false;
+}
+
+// Consume the next chunk. Only the last (possibly incomplete) token is copied.
+void StreamingSweepParser::feed(const char *data, int size)
+{
+    if (!m_sweep) begin(m_expected);
+
+    const char *p = data;
+    const char *end = data + size;
+
+    // Complete the token carried over from the previous chunk.
+    if (!m_carry.isEmpty()) {
+        const char *comma = static_cast<const char *>(std::memchr(p, ',', size_t(end - p)));
+        if (!comma) {
+            m_carry.append(p, int(end - p));
+            return;
+        }
+        m_carry.append(p, int(comma - p));
+        appendToken(m_carry.constData(), m_carry.constData() + m_carry.size());
+        m_carry.clear();
+        p = comma + 1;
+    }
+
+    while (p < end) {
+        const char *comma = static_cast<const char *>(std::memchr(p, ',', size_t(end - p)));
+        if (!comma) {
+            m_carry.append(p, int(end - p));
+            return;
+        }
+        appendToken(p, comma);
+        p = comma + 1;
+    }
+}
+
+// End of the reply: convert the carried token and hand over the sweep.
+QSharedPointer<SweepData> StreamingSweepParser::finish()
+{
+    if (!m_sweep) begin(m_expected);
+    if (!m_carry.isEmpty()) {
+        appendToken(m_carry.constData(), m_carry.constData() + m_carry.size());
+        m_carry.clear();
+    }
+    m_haveRe = false;
+
+    // Next sweep is most likely the same size.
+    m_expected = m_sweep->re.size();
+    QSharedPointer<SweepData> sweep = m_sweep;
+    m_sweep.reset();
+    return sweep;
+}
+
+// Drop the current sweep.
+void StreamingSweepParser::reset()
+{
+    m_sweep.reset();
+    m_carry.clear();
+    m_haveRe = false;
+}
+
+// Convert one token (locale independent). Empty tokens are skipped like
+// consecutive commas in the one-shot parser; an invalid part zeroes its pair.
+void StreamingSweepParser::appendToken(const char *begin, const char *end)
+{
+    while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\r')) ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+    if (begin == end) return;
+
+    if (*begin == '+') ++begin;
+
+    double value = 0.0;
+    const auto result = std::from_chars(begin, end, value);
+    const bool ok = result.ec == std::errc() && result.ptr == end;
+
+    if (!m_haveRe) {
+        m_re = value;
+        m_reOk = ok;
+        m_haveRe = true;
+        return;
+    }
+    m_haveRe = false;
+
+    const bool pairOk = m_reOk && ok;
+    m_sweep->re.append(pairOk ? m_re : 0.0);
+    m_sweep->im.append(pairOk ? value : 0.0);
+}
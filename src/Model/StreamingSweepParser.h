@@ -0,0 +1,48 @@
+// Streaming sweep parser (Model) module.
+// Converts the ASCII :CALC:DATA:SDAT? reply chunk by chunk while it is still arriving.
+
+#ifndef STREAMINGSWEEPPARSER_H
+#define STREAMINGSWEEPPARSER_H
+
+#include "Model/SweepData.h"
+
+#include <QByteArray>
+
+
+// Resumable "re,im,re,im,...\n" parser. A number split across two chunks is kept
+// in a small carry buffer, everything else is converted in place, so the sweep is
+// ready one chunk's parse time after the last byte arrives.
+class StreamingSweepParser
+{
+public:
+    StreamingSweepParser() = default;
+
+    // Start a new sweep; expectedPoints only sizes the buffers.
+    void begin(int expectedPoints);
+
+    // Consume the next chunk of the reply (without the terminating '\n').
+    void feed(const char *data, int size);
+
+    // Complex points converted so far.
+    int points() const { return m_sweep ? m_sweep->re.size() : 0; }
+
+    // End of the reply: convert the carried token and hand over the sweep.
+    // The grid (start/stop/index) and timing are left to the caller.
+    QSharedPointer<SweepData> finish();
+
+    // Drop the current sweep (connection reset).
+    void reset();
+
+private:
+    // Convert one complete token; invalid tokens become zero to keep the grid aligned.
+    void appendToken(const char *begin, const char *end);
+
+    QSharedPointer<SweepData> m_sweep;
+    QByteArray m_carry;             // Token split at the end of the previous chunk.
+    double m_re = 0.0;              // Real part waiting for its imaginary part.
+    bool m_reOk = false;
+    bool m_haveRe = false;
+    int m_expected = 0;
+};
+
+#endif // STREAMINGSWEEPPARSER_H
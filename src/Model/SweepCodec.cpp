@@ -0,0 +1,241 @@
+// Sweep codec (Model) module.
+
+#include "Model/SweepCodec.h"
+
+#include <QtAlgorithms>
+#include <cstring>
+
+
+namespace {
+quint64 doubleBits(double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(quint64 bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+quint64 lowMask(int n)
+{
+    return n >= 64 ? ~quint64(0) : (quint64(1) << n) - 1;
+}
+
+// LSB-first reader over little-endian 64-bit words. Reading past the end
+// returns zeros and sets `overrun`.
+class BitReader
+{
+public:
+    BitReader(const char *data, int size)
+        : m_p(reinterpret_cast<const uchar *>(data)), m_end(m_p + size) {}
+
+    // Next n bits (1..64).
+    quint64 get(int n)
+    {
+        if (n <= m_avail) {
+            const quint64 v = m_acc & lowMask(n);
+            m_acc = n == 64 ? 0 : m_acc >> n;
+            m_avail -= n;
+            return v;
+        }
+        const quint64 next = word();
+        const int rest = n - m_avail;
+        const quint64 v = (m_acc | (next << m_avail)) & lowMask(n);
+        m_acc = rest == 64 ? 0 : next >> rest;
+        m_avail = 64 - rest;
+        return v;
+    }
+
+    bool overrun() const { return m_overrun; }
+
+private:
+    quint64 word()
+    {
+        if (m_end - m_p < 8) {
+            m_overrun = true;
+            return 0;
+        }
+        quint64 w;
+        std::memcpy(&w, m_p, sizeof(w));
+        m_p += sizeof(w);
+        return w;
+    }
+
+    const uchar *m_p;
+    const uchar *m_end;
+    quint64 m_acc = 0;
+    int m_avail = 0;
+    bool m_overrun = false;
+};
+
+// Decoder side of a Gorilla window.
+struct DecodeWindow
+{
+    int length = 0;
+    int trailing = 0;
+};
+
+inline bool getValue(BitReader& reader, double prediction, DecodeWindow& window, double& value)
+{
+    quint64 bits = doubleBits(prediction);
+    if (reader.get(1)) {
+        if (reader.get(1)) {
+            const int header = int(reader.get(12));
+            const int leading = header & 63;
+            window.length = (header >> 6) + 1;
+            window.trailing = 64 - leading - window.length;
+            if (window.trailing < 0) return false;
+        } else if (window.length == 0) {
+            return false;               // Window reused before one was set.
+        }
+        bits ^= reader.get(window.length) << window.trailing;
+    }
+    value = bitsDouble(bits);
+    return true;
+}
+}
+
+
+// Start a new block of sweeps with `points` points.
+void SweepBlockEncoder::begin(int points)
+{
+    m_words.clear();
+    m_acc = 0;
+    m_used = 0;
+    m_points = points;
+    m_count = 0;
+    m_prevRe.resize(points);
+    m_prevIm.resize(points);
+}
+
+// Append n bits (1..64, value < 2^n).
+void SweepBlockEncoder::put(quint64 value, int n)
+{
+    m_acc |= value << m_used;
+    const int total = m_used + n;
+    if (total < 64) {
+        m_used = total;
+        return;
+    }
+    m_words.append(m_acc);
+    m_used = total - 64;
+    m_acc = m_used > 0 ? value >> (n - m_used) : 0;
+}
+
+void SweepBlockEncoder::putValue(double value, double prediction, Window& window)
+{
+    const quint64 x = doubleBits(value) ^ doubleBits(prediction);
+    if (x == 0) {
+        put(0, 1);
+        return;
+    }
+
+    const int leading = int(qCountLeadingZeroBits(x));
+    const int trailing = int(qCountTrailingZeroBits(x));
+    if (leading >= window.leading && trailing >= window.trailing) {
+        put(0x1, 2);
+        put(x >> window.trailing, 64 - window.leading - window.trailing);
+        return;
+    }
+
+    const int length = 64 - leading - trailing;
+    put(0x3 | quint64(leading) << 2 | quint64(length - 1) << 8, 14);
+    put(x >> trailing, length);
+    window.leading = leading;
+    window.trailing = trailing;
+}
+
+// Encode the next sweep against the previous one of the block.
+void SweepBlockEncoder::add(const SweepData& sweep)
+{
+    Q_ASSERT(sweep.size() == m_points);
+    const double *re = sweep.re.constData();
+    const double *im = sweep.im.constData();
+    double *prevRe = m_prevRe.data();
+    double *prevIm = m_prevIm.data();
+    Window windowRe;
+    Window windowIm;
+
+    if (m_count == 0) {
+        double predRe = 0.0;
+        double predIm = 0.0;
+        for (int i = 0; i < m_points; ++i) {
+            putValue(re[i], predRe, windowRe);
+            putValue(im[i], predIm, windowIm);
+            predRe = re[i];
+            predIm = im[i];
+        }
+    } else {
+        for (int i = 0; i < m_points; ++i) {
+            putValue(re[i], prevRe[i], windowRe);
+            putValue(im[i], prevIm[i], windowIm);
+        }
+    }
+
+    std::memcpy(prevRe, re, size_t(m_points) * sizeof(double));
+    std::memcpy(prevIm, im, size_t(m_points) * sizeof(double));
+    ++m_count;
+}
+
+// Close the block and return its payload (whole words).
+QByteArray SweepBlockEncoder::finish()
+{
+    if (m_used > 0) {
+        m_words.append(m_acc);
+        m_acc = 0;
+        m_used = 0;
+    }
+    return QByteArray(reinterpret_cast<const char *>(m_words.constData()),
+                      m_words.size() * int(sizeof(quint64)));
+}
+
+
+// Decode the sweeps of a block payload.
+bool decodeSweepBlock(const char *data,
+                      int size,
+                      int points,
+                      int count,
+                      QVector<QSharedPointer<SweepData>>& sweeps)
+{
+    sweeps.clear();
+    sweeps.reserve(count);
+    BitReader reader(data, size);
+    const SweepData *prev = nullptr;
+
+    for (int s = 0; s < count; ++s) {
+        QSharedPointer<SweepData> sweep(new SweepData);
+        sweep->re.resize(points);
+        sweep->im.resize(points);
+        double *re = sweep->re.data();
+        double *im = sweep->im.data();
+        DecodeWindow windowRe;
+        DecodeWindow windowIm;
+        bool ok = true;
+
+        if (!prev) {
+            double predRe = 0.0;
+            double predIm = 0.0;
+            for (int i = 0; i < points && ok; ++i) {
+                ok = getValue(reader, predRe, windowRe, re[i]) && getValue(reader, predIm, windowIm, im[i]);
+                predRe = re[i];
+                predIm = im[i];
+            }
+        } else {
+            const double *prevRe = prev->re.constData();
+            const double *prevIm = prev->im.constData();
+            for (int i = 0; i < points && ok; ++i) {
+                ok = getValue(reader, prevRe[i], windowRe, re[i]) && getValue(reader, prevIm[i], windowIm, im[i]);
+            }
+        }
+
+        if (!ok || reader.overrun()) return false;
+        sweeps.append(sweep);
+        prev = sweep.data();
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+// Sweep codec (Model) module.
+// Lossless XOR compression of consecutive complex sweeps (Gorilla style).
+
+#ifndef SWEEPCODEC_H
+#define SWEEPCODEC_H
+
+#include "Model/SweepData.h"
+
+#include <QByteArray>
+#include <QVector>
+
+
+// Every value is XORed with its prediction: the same point of the previous sweep,
+// or the previous point for the first sweep of a block. The XOR is stored as
+//   '0'                      - equal to the prediction
+//   '10' + bits              - meaningful bits fit the previous leading/trailing window
+//   '11' + 6 + 6 bits + bits - new window (leading zeros, length - 1), then the bits
+// Re and im are separate streams with their own window. Bits are packed LSB first
+// into little-endian 64-bit words.
+//
+// A block holds sweeps of one point count and depends on nothing outside itself.
+class SweepBlockEncoder
+{
+public:
+    SweepBlockEncoder() = default;
+
+    // Start a new block of sweeps with `points` points.
+    void begin(int points);
+
+    // Encode the next sweep (size must equal points()).
+    void add(const SweepData& sweep);
+
+    int points() const { return m_points; }
+    int count() const { return m_count; }
+
+    // Encoded size so far, bytes.
+    int bytes() const { return (m_words.size() + (m_used > 0 ? 1 : 0)) * int(sizeof(quint64)); }
+
+    // Close the block and return its payload.
+    QByteArray finish();
+
+private:
+    struct Window
+    {
+        int leading = 64;           // 64 = no window yet.
+        int trailing = 0;
+    };
+
+    void put(quint64 value, int n);
+    void putValue(double value, double prediction, Window& window);
+
+    QVector<quint64> m_words;
+    quint64 m_acc = 0;
+    int m_used = 0;                 // Bits used in m_acc.
+
+    QVector<double> m_prevRe;
+    QVector<double> m_prevIm;
+    int m_points = 0;
+    int m_count = 0;
+};
+
+
+// Decode the `count` sweeps of a block payload. Only re / im are filled in;
+// the grid, index and timing belong to the container. False on a corrupt payload.
+bool decodeSweepBlock(const char *data,
+                      int size,
+                      int points,
+                      int count,
+                      QVector<QSharedPointer<SweepData>>& sweeps);
+
+#endif // SWEEPCODEC_H
@@ -0,0 +1,190 @@
+// Sweep codec benchmark (Model) module.
+
+#include "Model/SweepCodecBenchmark.h"
+#include "Model/SweepRecording.h"
+#include "Model/ScpiCapture.h"
+#include "Model/StreamingSweepParser.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+
+// Drifting resonator with measurement noise (about -90 dB).
+QVector<SweepPtr> syntheticSweeps(int count, int points)
+{
+    std::mt19937 generator(1);
+    std::normal_distribution<double> noise(0.0, 3e-5);
+    QVector<SweepPtr> sweeps;
+    sweeps.reserve(count);
+
+    for (int s = 0; s < count; ++s) {
+        QSharedPointer<SweepData> sweep(new SweepData);
+        sweep->re.resize(points);
+        sweep->im.resize(points);
+        sweep->startHz = 1e9;
+        sweep->stopHz = 3e9;
+        sweep->index = quint64(s + 1);
+
+        const double center = 0.5 + 0.01 * std::sin(s * 0.05);     // Slow drift.
+        for (int i = 0; i < points; ++i) {
+            const double x = (double(i) / std::max(points - 1, 1) - center) * 40.0;
+            const double mag = 1.0 - 0.9 / (1.0 + x * x);
+            const double phase = -i * 0.02;
+            sweep->re[i] = mag * std::cos(phase) + noise(generator);
+            sweep->im[i] = mag * std::sin(phase) + noise(generator);
+        }
+        sweeps.append(sweep);
+    }
+    return sweeps;
+}
+
+// Sweep replies in a SCPI capture: read lines with more than a few values.
+bool capturedSweeps(const QString& path, QVector<SweepPtr>& sweeps, QString* error)
+{
+    QVector<ScpiCaptureRecord> records;
+    if (!readScpiCapture(path, records, error)) return false;
+
+    QByteArray stream;
+    for (const ScpiCaptureRecord& record : records) {
+        if (record.direction == ScpiCaptureRecord::Direction::Read) stream += record.data;
+    }
+
+    sweeps.clear();
+    StreamingSweepParser parser;
+    int from = 0;
+    while (from < stream.size()) {
+        int end = stream.indexOf('\n', from);
+        if (end < 0) end = stream.size();
+        if (std::count(stream.constBegin() + from, stream.constBegin() + end, ',') >= 3) {
+            parser.begin(0);
+            parser.feed(stream.constData() + from, end - from);
+            QSharedPointer<SweepData> sweep = parser.finish();
+            sweep->index = quint64(sweeps.size() + 1);
+            sweeps.append(sweep);
+        }
+        from = end + 1;
+    }
+
+    if (sweeps.isEmpty()) {
+        if (error) *error = "No sweep replies in the capture";
+        return false;
+    }
+    return true;
+}
+
+namespace {
+// Sweep n of a recording against the original, bit for bit, with its index and time.
+bool sameSweep(SweepRecordReader& reader, qint64 n, const SweepData& original, qint64 timeMs)
+{
+    qint64 readTimeMs = 0;
+    const SweepPtr sweep = reader.read(n, &readTimeMs);
+    if (!sweep || sweep->size() != original.size() || sweep->index != original.index || readTimeMs != timeMs) {
+        return false;
+    }
+    const size_t bytes = size_t(original.size()) * sizeof(double);
+    return std::memcmp(original.re.constData(), sweep->re.constData(), bytes) == 0
+           && std::memcmp(original.im.constData(), sweep->im.constData(), bytes) == 0;
+}
+
+// Recording time of sweep s: about 300 ms apart, with jitter for the time deltas.
+qint64 sweepTimeMs(int s)
+{
+    return 1000 + qint64(s) * 300 + (s * 37) % 11;
+}
+}
+
+
+// Through the recording itself: written with SweepRecordWriter to a temporary file,
+// read back in random order with SweepRecordReader (block table, index, trailer),
+// then a copy cut inside the last blocks is read through the rebuilt index.
+void runSweepCodecBenchmark(const QString& label, const QVector<SweepPtr>& sweeps, QTextStream& out)
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("bench.rec");
+    const QString truncatedPath = dir.filePath("truncated.rec");
+    QString error;
+    qint64 rawBytes = 0;
+
+    SweepRecordWriter writer;
+    QElapsedTimer timer;
+    timer.start();
+    if (!dir.isValid() || !writer.open(path, &error)) {
+        out << label << ": " << (dir.isValid() ? error : QString("No temporary directory")) << "\n";
+        return;
+    }
+    for (int s = 0; s < sweeps.size(); ++s) {
+        writer.append(*sweeps[s], sweepTimeMs(s));
+        rawBytes += qint64(sweeps[s]->size()) * 2 * qint64(sizeof(double));
+    }
+    writer.close();
+    const qint64 encodeNs = std::max<qint64>(timer.nsecsElapsed(), 1);
+    const qint64 fileBytes = QFileInfo(path).size();
+
+    // Random access: every sweep once, in shuffled order, checked.
+    SweepRecordReader reader;
+    if (!reader.open(path, &error)) {
+        out << label << ": " << error << "\n";
+        return;
+    }
+    QVector<int> order(sweeps.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(2));
+    bool exact = reader.sweepCount() == sweeps.size();
+    timer.restart();
+    for (int n : order) exact = sameSweep(reader, n, *sweeps[n], sweepTimeMs(n)) && exact;
+    const qint64 randomNs = std::max<qint64>(timer.nsecsElapsed(), 1);
+
+    // Sequential decode for at least 200 ms (each block decoded once per round).
+    int rounds = 0;
+    timer.restart();
+    do {
+        for (qint64 n = 0; n < reader.sweepCount(); ++n) exact = reader.read(n) && exact;
+        ++rounds;
+    } while (timer.elapsed() < 200);
+    const qint64 decodeNs = std::max<qint64>(timer.nsecsElapsed() / rounds, 1);
+    reader.close();
+
+    // Unclosed writer: no trailer and a partial last block.
+    QFile source(path);
+    QFile truncated(truncatedPath);
+    QString truncatedResult = "not written";
+    if (source.open(QIODevice::ReadOnly) && truncated.open(QIODevice::WriteOnly)) {
+        truncated.write(source.read(fileBytes * 3 / 4));
+        truncated.close();
+        if (reader.open(truncatedPath, &error)) {
+            const qint64 recovered = reader.sweepCount();
+            bool truncatedExact = recovered <= sweeps.size();
+            for (qint64 n = 0; n < recovered && truncatedExact; ++n) {
+                truncatedExact = sameSweep(reader, n, *sweeps[int(n)], sweepTimeMs(int(n)));
+            }
+            reader.close();
+            truncatedResult = QString("%1 sweep(s) recovered, %2").arg(recovered).arg(truncatedExact ? "exact" : "MISMATCH");
+        } else {
+            truncatedResult = error;
+        }
+    }
+
+    out << QString("%1: %2 sweep(s) x %3 points, %4 -> %5 bytes, ratio %6, "
+                   "write %7 MB/s (%8 sweeps/s), decode %9 GB/s, random read %10 sweeps/s, %11; "
+                   "truncated at 3/4: %12\n")
+               .arg(label)
+               .arg(sweeps.size())
+               .arg(sweeps.isEmpty() ? 0 : sweeps.first()->size())
+               .arg(rawBytes)
+               .arg(fileBytes)
+               .arg(double(rawBytes) / std::max<qint64>(fileBytes, 1), 0, 'f', 2)
+               .arg(rawBytes * 1e3 / encodeNs, 0, 'f', 0)
+               .arg(sweeps.size() * 1e9 / encodeNs, 0, 'f', 0)
+               .arg(double(rawBytes) / decodeNs, 0, 'f', 2)
+               .arg(sweeps.size() * 1e9 / randomNs, 0, 'f', 0)
+               .arg(exact ? "lossless" : "MISMATCH")
+               .arg(truncatedResult);
+    out.flush();
+}
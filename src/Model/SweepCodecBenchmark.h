@@ -0,0 +1,25 @@
+// Sweep codec benchmark (Model) module.
+// Compression ratio, write / read speed and random access of the sweep recording (--codec-bench).
+
+#ifndef SWEEPCODECBENCHMARK_H
+#define SWEEPCODECBENCHMARK_H
+
+#include "Model/SweepData.h"
+
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+
+
+// Drifting resonator with measurement noise, `count` sweeps of `points` points.
+QVector<SweepPtr> syntheticSweeps(int count, int points);
+
+// Sweep replies found in a SCPI capture (--capture file).
+bool capturedSweeps(const QString& path, QVector<SweepPtr>& sweeps, QString* error = nullptr);
+
+// Record the sweeps to a temporary file, read them back in random order and in
+// sequence, check sweeps, indices and times are exact (also from a truncated,
+// unclosed copy) and print one result line.
+void runSweepCodecBenchmark(const QString& label, const QVector<SweepPtr>& sweeps, QTextStream& out);
+
+#endif // SWEEPCODECBENCHMARK_H
@@ -0,0 +1,40 @@
+// Sweep data (Model) module.
+// Raw complex sweep as received from the S2VNA, shared between processing steps.
+
+#ifndef SWEEPDATA_H
+#define SWEEPDATA_H
+
+#include <QVector>
+#include <QSharedPointer>
+#include <QMetaType>
+
+
+// Complex S-parameter sweep over a linear frequency grid.
+// Real and imaginary parts are stored in separate arrays for tight numeric loops.
+struct SweepData
+{
+    QVector<double> re;             // Real part per point.
+    QVector<double> im;             // Imaginary part per point.
+    double startHz{0.0};            // First grid frequency, Hz.
+    double stopHz{0.0};             // Last grid frequency, Hz.
+    quint64 index{0};               // Sweep sequence number.
+
+    // Acquisition timing, ns (0 = unknown).
+    qint64 acquireNs{0};            // Request (or previous reply) -> first byte.
+    qint64 transferNs{0};           // First -> last byte.
+    qint64 parseNs{0};              // Conversion time.
+
+    int size() const { return re.size(); }
+
+    // Grid step between points, Hz.
+    double stepHz() const { return size() > 1 ? (stopHz - startHz) / (size() - 1) : 0.0; }
+
+    // Frequency of point i, Hz.
+    double freqHz(int i) const { return startHz + stepHz() * i; }
+};
+
+using SweepPtr = QSharedPointer<const SweepData>;
+
+Q_DECLARE_METATYPE(SweepPtr)
+
+#endif // SWEEPDATA_H
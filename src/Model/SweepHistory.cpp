@@ -0,0 +1,44 @@
+// Sweep history (Model) module.
+// Fixed-size ring buffer of the last N sweeps (one scalar value per point).
+
+#include "Model/SweepHistory.h"
+
+#include <algorithm>
+
+
+// Preallocate the ring and drop the history.
+void SweepHistory::reset(int rows, int columns)
+{
+    m_rows = std::max(rows, 1);
+    m_columns = std::max(columns, 0);
+    m_data.fill(0.0f, m_rows * m_columns);
+    m_head = 0;
+    m_count = 0;
+}
+
+// Append one sweep. The newest row moves "up" the ring so that the rows
+// from newest to oldest are stored in increasing order (with one wrap).
+int SweepHistory::append(const double* values, int n)
+{
+    if (n != m_columns || m_rows == 0) reset(m_rows, n);
+
+    m_head = (m_head + m_rows - 1) % m_rows;
+    m_count = std::min(m_count + 1, m_rows);
+
+    float* dst = m_data.data() + qint64(m_head) * m_columns;
+    for (int i = 0; i < n; ++i) dst[i] = float(values[i]);
+    return m_head;
+}
+
+// Row by age: 0 = newest.
+const float* SweepHistory::row(int age) const
+{
+    if (age < 0 || age >= m_count) return nullptr;
+    return m_data.constData() + qint64(ringIndex(age)) * m_columns;
+}
+
+// Ring row index of the row with the given age.
+int SweepHistory::ringIndex(int age) const
+{
+    return m_rows > 0 ? (m_head + age) % m_rows : 0;
+}
@@ -0,0 +1,45 @@
+// Sweep history (Model) module.
+// Fixed-size ring buffer of the last N sweeps (one scalar value per point).
+
+#ifndef SWEEPHISTORY_H
+#define SWEEPHISTORY_H
+
+#include <QVector>
+
+
+// Memory is allocated once in reset(): rows * columns floats.
+// Appending a sweep overwrites the oldest row, nothing is reallocated.
+class SweepHistory
+{
+public:
+    SweepHistory() = default;
+
+    // Preallocate the ring for `rows` sweeps of `columns` points and drop the history.
+    void reset(int rows, int columns);
+
+    int capacity() const { return m_rows; }
+    int columns() const { return m_columns; }
+    int count() const { return m_count; }
+
+    // Allocated memory, bytes.
+    qint64 memoryBytes() const { return qint64(m_data.size()) * sizeof(float); }
+
+    // Append one sweep, returns the ring row it was stored in.
+    // The history is reset if the number of points changed.
+    int append(const double* values, int n);
+
+    // Row by age: 0 = newest, count() - 1 = oldest.
+    const float* row(int age) const;
+
+    // Ring row index of the row with the given age.
+    int ringIndex(int age) const;
+
+private:
+    QVector<float> m_data;
+    int m_rows = 0;
+    int m_columns = 0;
+    int m_head = 0;         // Ring row of the newest sweep.
+    int m_count = 0;
+};
+
+#endif // SWEEPHISTORY_H
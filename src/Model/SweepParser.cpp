@@ -0,0 +1,72 @@
+// Sweep parser (Model) module.
+
+#include "Model/SweepParser.h"
+#include "Model/Metrics.h"
+
+#include <QStringList>
+#include <algorithm>
+
+
+namespace {
+
+// Use configured number of points; fall back to 101 if invalid.
+int gridPoints(const VnaConfig& cfg)
+{
+    int numPoints = cfg.points > 0 ? cfg.points : 101;
+    return numPoints <= 1 ? 2 : numPoints;
+}
+
+// Frequencies of the parsed points. Start/stop are stored in GHz, the sweep uses Hz.
+void setGrid(SweepData& sweep, const VnaConfig& cfg, quint64 index)
+{
+    double startHz = cfg.startFreq * 1e9;
+    double stopHz = cfg.stopFreq * 1e9;
+    double stepHz = (stopHz - startHz) / (gridPoints(cfg) - 1);
+
+    sweep.startHz = startHz;
+    sweep.stopHz = startHz + stepHz * std::max(sweep.size() - 1, 0);
+    sweep.index = index;
+}
+
+} // namespace
+
+// Sweep parsing method: keeps the raw complex data, formats are derived on demand.
+SweepPtr parseSGraph(const QString& rawData, const VnaConfig& cfg, quint64 index)
+{
+    ScopedLatency latency(Metrics::instance().parseNs);
+
+    QSharedPointer<SweepData> sweep(new SweepData);
+
+    // Split raw comma-separated string into individual numeric tokens.
+    // Example input: 0.1, -0.2 ,0.3...
+    QStringList parts = rawData.split(',', Qt::SkipEmptyParts);
+
+    // Parse real/imaginary pairs. Invalid pairs are stored as zero to keep the grid aligned.
+    int count = std::min(gridPoints(cfg), int(parts.size() / 2));
+    sweep->re.resize(count);
+    sweep->im.resize(count);
+    for (int i = 0; i < count; ++i) {
+        bool ok1, ok2;
+        double re = parts[2 * i].toDouble(&ok1);            // Real part.
+        double im = parts[2 * i + 1].toDouble(&ok2);        // Imaginary part.
+
+        sweep->re[i] = (ok1 && ok2) ? re : 0.0;
+        sweep->im[i] = (ok1 && ok2) ? im : 0.0;
+    }
+
+    setGrid(*sweep, cfg, index);
+    return sweep;
+}
+
+// Put already converted values on the grid of the configuration.
+SweepPtr applySweepGrid(const SweepPtr& values, const VnaConfig& cfg, quint64 index)
+{
+    QSharedPointer<SweepData> sweep(new SweepData(*values));
+    const int count = std::min(gridPoints(cfg), sweep->size());
+    if (count < sweep->size()) {
+        sweep->re.resize(count);
+        sweep->im.resize(count);
+    }
+    setGrid(*sweep, cfg, index);
+    return sweep;
+}
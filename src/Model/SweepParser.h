@@ -0,0 +1,21 @@
+// Sweep parser (Model) module.
+// Converts the ASCII :CALC:DATA:SDAT? reply into the complex sweep.
+
+#ifndef SWEEPPARSER_H
+#define SWEEPPARSER_H
+
+#include "Interfaces/IVnaConfig.h"
+#include "Model/SweepData.h"
+
+#include <QString>
+
+
+// Parse "re,im,re,im,..." on the grid of the given configuration.
+// Thread-safe: works only on its arguments (the config is a snapshot).
+SweepPtr parseSGraph(const QString& rawData, const VnaConfig& cfg, quint64 index);
+
+// Put already converted values (streaming parser) on the grid of the configuration.
+// Shares the value arrays with the input, they are only cut if longer than the grid.
+SweepPtr applySweepGrid(const SweepPtr& values, const VnaConfig& cfg, quint64 index);
+
+#endif // SWEEPPARSER_H
@@ -0,0 +1,150 @@
+// Sweep rate model (Model) module.
+
+#include "Model/SweepRateModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+template <int K>
+void SweepRateModel::LeastSquares<K>::add(const std::array<double, K>& x, double y)
+{
+    for (int r = 0; r < K; ++r) {
+        for (int c = 0; c < K; ++c) ata[r * K + c] += x[r] * x[c];
+        aty[r] += x[r] * y;
+    }
+}
+
+// Gaussian elimination with partial pivoting on the K x K normal equations.
+template <int K>
+std::array<double, K> SweepRateModel::LeastSquares<K>::solve(bool full) const
+{
+    std::array<double, K> coef{};
+    if (ata[0] <= 0.0) return coef;
+
+    if (full) {
+        std::array<double, K * K> a = ata;
+        std::array<double, K> b = aty;
+        bool singular = false;
+
+        for (int col = 0; col < K && !singular; ++col) {
+            int pivot = col;
+            for (int r = col + 1; r < K; ++r) {
+                if (std::abs(a[r * K + col]) > std::abs(a[pivot * K + col])) pivot = r;
+            }
+            if (std::abs(a[pivot * K + col]) <= 1e-12 * std::abs(ata[col * K + col])) {
+                singular = true;
+                break;
+            }
+            for (int c = 0; c < K; ++c) std::swap(a[col * K + c], a[pivot * K + c]);
+            std::swap(b[col], b[pivot]);
+
+            for (int r = col + 1; r < K; ++r) {
+                const double f = a[r * K + col] / a[col * K + col];
+                for (int c = col; c < K; ++c) a[r * K + c] -= f * a[col * K + c];
+                b[r] -= f * b[col];
+            }
+        }
+
+        if (!singular) {
+            for (int r = K - 1; r >= 0; --r) {
+                double s = b[r];
+                for (int c = r + 1; c < K; ++c) s -= a[r * K + c] * coef[c];
+                coef[r] = s / a[r * K + r];
+            }
+            return coef;
+        }
+        coef = {};
+    }
+
+    // Proportional to the main term: sum(y) / sum(x1).
+    if (ata[1] > 0.0) coef[1] = aty[0] / ata[1];
+    return coef;
+}
+
+
+void SweepRateModel::addSample(const SweepTiming& sample)
+{
+    if (sample.points <= 0 || sample.ifBw <= 0) return;
+
+    const double n = sample.points;
+    m_acquire.add({ 1.0, n / sample.ifBw, n }, sample.acquireMs);
+    m_transfer.add({ 1.0, n }, sample.transferMs);
+    m_parse.add({ 1.0, n }, sample.parseMs);
+    m_render.add({ 1.0, n }, sample.renderMs);
+    m_configs.insert(qMakePair(sample.points, sample.ifBw));
+    ++m_samples;
+}
+
+void SweepRateModel::clear()
+{
+    *this = SweepRateModel();
+}
+
+// Predicted breakdown (negative fits are clamped to zero).
+SweepTiming SweepRateModel::predict(int points, int ifBw) const
+{
+    const bool full = m_configs.size() >= 3;
+    const double n = points;
+    const double nb = ifBw > 0 ? n / ifBw : 0.0;
+
+    const auto a = m_acquire.solve(full);
+    const auto t = m_transfer.solve(full);
+    const auto p = m_parse.solve(full);
+    const auto r = m_render.solve(full);
+
+    SweepTiming timing;
+    timing.points = points;
+    timing.ifBw = ifBw;
+    timing.acquireMs = std::max(a[0] + a[1] * nb + a[2] * n, 0.0);
+    timing.transferMs = std::max(t[0] + t[1] * n, 0.0);
+    timing.parseMs = std::max(p[0] + p[1] * n, 0.0);
+    timing.renderMs = std::max(r[0] + r[1] * n, 0.0);
+    return timing;
+}
+
+// Refresh rate, Hz.
+double SweepRateModel::predictedRateHz(int points, int ifBw) const
+{
+    const SweepTiming t = predict(points, ifBw);
+    const double periodMs = std::max({ t.acquireMs + t.transferMs, t.parseMs, t.renderMs });
+    return periodMs > 0.0 ? 1000.0 / periodMs : 0.0;
+}
+
+// Narrowest IF bandwidth that reaches the target at minPoints. Above the reachable
+// rate (often set by the parse or render time) a wider one only adds noise, so the narrowest
+// one that already reaches the highest predicted rate is taken instead.
+RateSuggestion SweepRateModel::suggest(double targetHz, int minPoints) const
+{
+    RateSuggestion best;
+    if (m_samples == 0 || minPoints < 2) return best;
+
+    const QVector<int>& steps = ifBwSteps();
+    QVector<double> rates(steps.size());
+    double maxHz = 0.0;
+    for (int i = 0; i < steps.size(); ++i) {
+        rates[i] = predictedRateHz(minPoints, steps[i]);
+        maxHz = std::max(maxHz, rates[i]);
+    }
+
+    const bool reachable = maxHz >= targetHz;
+    const double wantedHz = reachable ? targetHz : maxHz * (1.0 - 1e-9);
+    int i = 0;
+    while (i < steps.size() - 1 && rates[i] < wantedHz) ++i;
+
+    best.valid = true;
+    best.meetsTarget = reachable;
+    best.points = minPoints;
+    best.ifBw = steps[i];
+    best.predictedHz = rates[i];
+    best.timing = predict(best.points, best.ifBw);
+    return best;
+}
+
+// IF bandwidths offered by the S2VNA within the range of the IF bandwidth
+// field (10 Hz .. 10 kHz), Hz (ascending).
+const QVector<int>& SweepRateModel::ifBwSteps()
+{
+    static const QVector<int> steps = { 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+    return steps;
+}
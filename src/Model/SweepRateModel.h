@@ -0,0 +1,89 @@
+// Sweep rate model (Model) module.
+// Learns how the per-sweep time scales with points and IF bandwidth and suggests
+// the configuration for a target refresh rate.
+
+#ifndef SWEEPRATEMODEL_H
+#define SWEEPRATEMODEL_H
+
+#include <QVector>
+#include <QSet>
+#include <QPair>
+#include <array>
+
+
+// Measured (or predicted) time of one sweep, ms.
+struct SweepTiming
+{
+    int points{0};
+    int ifBw{0};
+    double acquireMs{0.0};          // Request -> first byte (instrument sweep).
+    double transferMs{0.0};         // First -> last byte.
+    double parseMs{0.0};            // Conversion, overlapped with the transfer.
+    double renderMs{0.0};           // Chart update.
+};
+
+// Result of SweepRateModel::suggest().
+struct RateSuggestion
+{
+    bool valid{false};              // False without timing data.
+    bool meetsTarget{false};
+    int points{0};
+    int ifBw{0};
+    double predictedHz{0.0};
+    SweepTiming timing;             // Predicted breakdown.
+};
+
+
+// Per-part linear models, fitted by least squares over all samples:
+//   acquire  = a0 + a1 * points / ifBw + a2 * points
+//   transfer = b0 + b1 * points  (parse, render alike)
+// Samples are accumulated into the normal equations, so adding one is O(1).
+// Until three different configurations were seen the fit is underdetermined and
+// each part is scaled in proportion to its main term (points / ifBw or points).
+class SweepRateModel
+{
+public:
+    SweepRateModel() = default;
+
+    void addSample(const SweepTiming& sample);
+    void clear();
+
+    int sampleCount() const { return m_samples; }
+    int configurationCount() const { return m_configs.size(); }
+
+    // Predicted breakdown for a configuration.
+    SweepTiming predict(int points, int ifBw) const;
+
+    // Refresh rate, Hz: the link is busy for acquire + transfer; parse and render
+    // run in parallel with the next sweep (requested as soon as a reply is complete).
+    double predictedRateHz(int points, int ifBw) const;
+
+    // Narrowest IF bandwidth (lowest noise) that reaches targetHz at minPoints; if the
+    // target cannot be reached, the narrowest one that reaches the highest predicted rate.
+    RateSuggestion suggest(double targetHz, int minPoints) const;
+
+    // IF bandwidths offered by the S2VNA and accepted by the View, Hz.
+    static const QVector<int>& ifBwSteps();
+
+private:
+    // Normal equations of y = c . x for K regressors (x[0] = 1).
+    template <int K>
+    struct LeastSquares
+    {
+        std::array<double, K * K> ata{};
+        std::array<double, K> aty{};
+
+        void add(const std::array<double, K>& x, double y);
+        // Full fit, or y proportional to x[1] when the system is singular.
+        std::array<double, K> solve(bool full) const;
+    };
+
+    LeastSquares<3> m_acquire;
+    LeastSquares<2> m_transfer;
+    LeastSquares<2> m_parse;
+    LeastSquares<2> m_render;
+    int m_samples = 0;
+    QSet<QPair<int, int>> m_configs;
+};
+
+#endif // SWEEPRATEMODEL_H
@@ -0,0 +1,300 @@
+// Sweep recording (Model) module.
+
+#include "Model/SweepRecording.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace {
+const char kMagic[8] = {'S', '2', 'V', 'N', 'A', 'R', 'E', 'C'};
+const char kIndexMagic[8] = {'S', '2', 'V', 'N', 'A', 'I', 'D', 'X'};
+const quint32 kVersion = 1;
+const quint32 kBlockMagic = 0x4B425753;     // "SWBK"
+const int kFileHeaderBytes = int(sizeof(kMagic) + sizeof(quint32));
+
+struct BlockHeader
+{
+    quint32 magic;
+    quint32 sweeps;
+    quint32 points;
+    quint32 tableBytes;
+    quint32 payloadBytes;
+    quint32 reserved;
+    double startHz;
+    double stopHz;
+    quint64 firstIndex;
+    qint64 firstTimeMs;
+};
+static_assert(sizeof(BlockHeader) == 56, "BlockHeader layout");
+
+struct Trailer
+{
+    quint64 indexOffset;
+    quint32 blocks;
+    quint32 reserved;
+    char magic[8];
+};
+static_assert(sizeof(Trailer) == 24, "Trailer layout");
+
+// LEB128 unsigned varint of a zigzag-coded delta.
+void appendDelta(QByteArray& out, qint64 delta)
+{
+    quint64 value = (quint64(delta) << 1) ^ quint64(delta >> 63);
+    while (value >= 0x80) {
+        out.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+bool readDelta(const uchar*& p, const uchar* end, qint64& delta)
+{
+    quint64 value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uchar byte = *p++;
+        value |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            delta = qint64(value >> 1) ^ -qint64(value & 1);
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+
+SweepRecordWriter::~SweepRecordWriter()
+{
+    close();
+}
+
+// Create the recording file.
+bool SweepRecordWriter::open(const QString& path, QString* error)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = m_file.errorString();
+        return false;
+    }
+
+    m_file.write(kMagic, sizeof(kMagic));
+    m_file.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+    m_encoder.begin(0);
+    m_index.clear();
+    m_sweeps = 0;
+    return true;
+}
+
+// Write the pending block, the index and the trailer.
+void SweepRecordWriter::close()
+{
+    if (!m_file.isOpen()) return;
+    if (m_encoder.count() > 0) writeBlock();
+
+    Trailer trailer{};
+    trailer.indexOffset = quint64(m_file.pos());
+    trailer.blocks = quint32(m_index.size());
+    std::memcpy(trailer.magic, kIndexMagic, sizeof(kIndexMagic));
+    m_file.write(reinterpret_cast<const char*>(m_index.constData()), m_index.size() * qint64(sizeof(IndexEntry)));
+    m_file.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    m_file.close();
+}
+
+// Append one sweep to the current block.
+void SweepRecordWriter::append(const SweepData& sweep, qint64 timeMs)
+{
+    if (!m_file.isOpen() || sweep.size() == 0) return;
+
+    if (m_encoder.count() > 0
+        && (sweep.size() != m_encoder.points() || sweep.startHz != m_startHz || sweep.stopHz != m_stopHz)) {
+        writeBlock();
+    }
+
+    if (m_encoder.count() == 0) {
+        m_encoder.begin(sweep.size());
+        m_table.clear();
+        m_startHz = sweep.startHz;
+        m_stopHz = sweep.stopHz;
+        m_firstIndex = m_lastIndex = sweep.index;
+        m_firstTimeMs = m_lastTimeMs = timeMs;
+    }
+
+    appendDelta(m_table, qint64(sweep.index - m_lastIndex));
+    appendDelta(m_table, timeMs - m_lastTimeMs);
+    m_lastIndex = sweep.index;
+    m_lastTimeMs = timeMs;
+
+    m_encoder.add(sweep);
+    ++m_sweeps;
+    if (m_encoder.count() == kBlockSweeps) writeBlock();
+}
+
+// Write the block and remember it in the index.
+void SweepRecordWriter::writeBlock()
+{
+    const QByteArray payload = m_encoder.finish();
+
+    BlockHeader header{};
+    header.magic = kBlockMagic;
+    header.sweeps = quint32(m_encoder.count());
+    header.points = quint32(m_encoder.points());
+    header.tableBytes = quint32(m_table.size());
+    header.payloadBytes = quint32(payload.size());
+    header.startHz = m_startHz;
+    header.stopHz = m_stopHz;
+    header.firstIndex = m_firstIndex;
+    header.firstTimeMs = m_firstTimeMs;
+
+    IndexEntry entry;
+    entry.offset = quint64(m_file.pos());
+    entry.firstSweep = quint64(m_sweeps - m_encoder.count());
+    entry.sweeps = header.sweeps;
+    entry.points = header.points;
+    m_index.append(entry);
+
+    m_buffer.resize(int(sizeof(header)));
+    std::memcpy(m_buffer.data(), &header, sizeof(header));
+    m_buffer += m_table;
+    m_file.write(m_buffer);
+    m_file.write(payload);
+    m_encoder.begin(0);
+}
+
+
+// Open a recording and load (or rebuild) its block index.
+bool SweepRecordReader::open(const QString& path, QString* error)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (error) *error = m_file.errorString();
+        return false;
+    }
+
+    char magic[sizeof(kMagic)];
+    if (m_file.read(magic, sizeof(magic)) != qint64(sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        if (error) *error = "Not a sweep recording";
+        close();
+        return false;
+    }
+
+    // Closed file: index at the end.
+    Trailer trailer{};
+    const qint64 size = m_file.size();
+    bool indexed = false;
+    if (size >= kFileHeaderBytes + qint64(sizeof(trailer)) && m_file.seek(size - qint64(sizeof(trailer)))
+        && m_file.read(reinterpret_cast<char*>(&trailer), sizeof(trailer)) == qint64(sizeof(trailer))
+        && std::memcmp(trailer.magic, kIndexMagic, sizeof(kIndexMagic)) == 0) {
+        const qint64 bytes = qint64(trailer.blocks) * qint64(sizeof(SweepRecordWriter::IndexEntry));
+        if (qint64(trailer.indexOffset) + bytes + qint64(sizeof(trailer)) == size && m_file.seek(qint64(trailer.indexOffset))) {
+            m_index.resize(int(trailer.blocks));
+            indexed = m_file.read(reinterpret_cast<char*>(m_index.data()), bytes) == bytes;
+        }
+    }
+    if (!indexed && !scanBlocks(error)) {
+        close();
+        return false;
+    }
+
+    m_sweeps = 0;
+    for (const auto& entry : m_index) m_sweeps += entry.sweeps;
+    return true;
+}
+
+void SweepRecordReader::close()
+{
+    m_file.close();
+    m_index.clear();
+    m_sweeps = 0;
+    m_cachedBlock = -1;
+    m_cache.clear();
+    m_cacheTimes.clear();
+}
+
+// Walk the block headers (the writer did not close the file). A truncated
+// last block is dropped.
+bool SweepRecordReader::scanBlocks(QString* error)
+{
+    m_index.clear();
+    qint64 offset = kFileHeaderBytes;
+    quint64 sweeps = 0;
+    const qint64 size = m_file.size();
+
+    BlockHeader header;
+    while (m_file.seek(offset) && m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) == qint64(sizeof(header))) {
+        if (header.magic != kBlockMagic) break;
+        const qint64 next = offset + qint64(sizeof(header)) + header.tableBytes + header.payloadBytes;
+        if (next > size) break;
+
+        m_index.append({ quint64(offset), sweeps, header.sweeps, header.points });
+        sweeps += header.sweeps;
+        offset = next;
+    }
+
+    if (m_index.isEmpty() && size > kFileHeaderBytes) {
+        if (error) *error = "Corrupt sweep recording";
+        return false;
+    }
+    return true;
+}
+
+// Decode one block into the cache.
+bool SweepRecordReader::loadBlock(int block)
+{
+    m_cachedBlock = -1;
+    BlockHeader header;
+    if (!m_file.seek(qint64(m_index[block].offset))
+        || m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != qint64(sizeof(header))
+        || header.magic != kBlockMagic) {
+        return false;
+    }
+
+    const QByteArray data = m_file.read(qint64(header.tableBytes) + header.payloadBytes);
+    if (data.size() != int(header.tableBytes + header.payloadBytes)) return false;
+    if (!decodeSweepBlock(data.constData() + header.tableBytes, int(header.payloadBytes),
+                          int(header.points), int(header.sweeps), m_cache)) {
+        return false;
+    }
+
+    const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+    const uchar* end = p + header.tableBytes;
+    quint64 index = header.firstIndex;
+    qint64 timeMs = header.firstTimeMs;
+    m_cacheTimes.resize(int(header.sweeps));
+    for (int i = 0; i < int(header.sweeps); ++i) {
+        qint64 indexDelta = 0;
+        qint64 timeDelta = 0;
+        if (!readDelta(p, end, indexDelta) || !readDelta(p, end, timeDelta)) return false;
+        index += quint64(indexDelta);
+        timeMs += timeDelta;
+
+        SweepData& sweep = *m_cache[i];
+        sweep.startHz = header.startHz;
+        sweep.stopHz = header.stopHz;
+        sweep.index = index;
+        m_cacheTimes[i] = timeMs;
+    }
+
+    m_cachedBlock = block;
+    return true;
+}
+
+// Sweep n in file order.
+SweepPtr SweepRecordReader::read(qint64 n, qint64* timeMs)
+{
+    if (n < 0 || n >= m_sweeps) return SweepPtr();
+
+    // Last block whose first sweep is <= n.
+    const auto it = std::upper_bound(m_index.cbegin(), m_index.cend(), quint64(n),
+                                     [](quint64 value, const SweepRecordWriter::IndexEntry& entry) {
+                                         return value < entry.firstSweep;
+                                     });
+    const int block = int(it - m_index.cbegin()) - 1;
+    if (block != m_cachedBlock && !loadBlock(block)) return SweepPtr();
+
+    const int i = int(n - qint64(m_index[block].firstSweep));
+    if (timeMs) *timeMs = m_cacheTimes[i];
+    return m_cache[i];
+}
@@ -0,0 +1,102 @@
+// Sweep recording (Model) module.
+// Compressed file of raw complex sweeps with random access by sweep number.
+//
+// File layout (little-endian):
+//   "S2VNAREC" magic, u32 version
+//   blocks:  BlockHeader, per-sweep table (varint index delta, varint time delta),
+//            SweepBlockEncoder payload
+//   index:   IndexEntry per block
+//   trailer: u64 index offset, u32 block count, u32 reserved, "S2VNAIDX" magic
+// Blocks are independent, so a sweep is read by decoding one block. A file without
+// a trailer (the writer did not close) is indexed by walking the block headers.
+
+#ifndef SWEEPRECORDING_H
+#define SWEEPRECORDING_H
+
+#include "Model/SweepCodec.h"
+#include "Model/SweepData.h"
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+
+// Appends sweeps to a recording, kBlockSweeps per block.
+class SweepRecordWriter
+{
+public:
+    static constexpr int kBlockSweeps = 32;
+
+    SweepRecordWriter() = default;
+    ~SweepRecordWriter();
+
+    bool open(const QString& path, QString* error = nullptr);
+    // Write the pending block and the index.
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Append one sweep. A new block starts when the grid changes.
+    void append(const SweepData& sweep, qint64 timeMs);
+
+    // Recorded sweeps and file size so far.
+    qint64 sweepCount() const { return m_sweeps; }
+    qint64 fileBytes() const { return m_file.isOpen() ? m_file.pos() : 0; }
+
+private:
+    void writeBlock();
+
+    QFile m_file;
+    SweepBlockEncoder m_encoder;
+    QByteArray m_table;             // Varint index / time deltas of the block.
+    QByteArray m_buffer;
+    double m_startHz = 0.0;
+    double m_stopHz = 0.0;
+    quint64 m_firstIndex = 0;
+    quint64 m_lastIndex = 0;
+    qint64 m_firstTimeMs = 0;
+    qint64 m_lastTimeMs = 0;
+    qint64 m_sweeps = 0;
+
+    struct IndexEntry
+    {
+        quint64 offset;
+        quint64 firstSweep;         // Number of the block's first sweep in the file.
+        quint32 sweeps;
+        quint32 points;
+    };
+    QVector<IndexEntry> m_index;
+
+    friend class SweepRecordReader;
+};
+
+
+// Random access to the sweeps of a recording. The last decoded block is kept,
+// so reading sweeps in order decodes every block once.
+class SweepRecordReader
+{
+public:
+    SweepRecordReader() = default;
+
+    bool open(const QString& path, QString* error = nullptr);
+    void close();
+
+    qint64 sweepCount() const { return m_sweeps; }
+
+    // Sweep n (0-based, file order) with its grid and sweep index; null on error.
+    SweepPtr read(qint64 n, qint64* timeMs = nullptr);
+
+private:
+    // Walk the block headers of a file without an index.
+    bool scanBlocks(QString* error);
+    bool loadBlock(int block);
+
+    QFile m_file;
+    QVector<SweepRecordWriter::IndexEntry> m_index;
+    qint64 m_sweeps = 0;
+
+    int m_cachedBlock = -1;
+    QVector<QSharedPointer<SweepData>> m_cache;
+    QVector<qint64> m_cacheTimes;
+};
+
+#endif // SWEEPRECORDING_H
@@ -0,0 +1,116 @@
+// Shared-memory handoff benchmark (Model) module.
+
+#include "Model/SweepShmBenchmark.h"
+#include "Model/SweepShmPublisher.h"
+#include "Model/SweepShmReader.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+
+namespace {
+constexpr std::int64_t kPublishIntervalNs = 200000;     // 200 us: the reader is idle at each publish.
+
+// Latency at quantile q of the sorted samples, us.
+double quantileUs(const std::vector<std::int64_t>& sorted, double q)
+{
+    if (sorted.empty()) return 0.0;
+    const size_t i = std::min(sorted.size() - 1, size_t(q * (sorted.size() - 1) + 0.5));
+    return sorted[i] / 1e3;
+}
+
+// Distinct sweeps, so a copy of the wrong slot is detected.
+QVector<SweepData> benchmarkSweeps(int count, int points)
+{
+    QVector<SweepData> sweeps(count);
+    for (int s = 0; s < count; ++s) {
+        SweepData& sweep = sweeps[s];
+        sweep.re.resize(points);
+        sweep.im.resize(points);
+        sweep.startHz = 1e9;
+        sweep.stopHz = 3e9;
+        sweep.index = quint64(s + 1);
+        for (int i = 0; i < points; ++i) {
+            sweep.re[i] = std::cos(i * 0.01 + s);
+            sweep.im[i] = std::sin(i * 0.01 + s);
+        }
+    }
+    return sweeps;
+}
+}
+
+
+// The reader spins on `latest` as a polling client would; the writer publishes at
+// a fixed interval so each sample is one handoff, not a queue behind the previous one.
+bool runSweepShmBenchmark(int count, int points, QTextStream& out)
+{
+    const QString name = QString("/s2vna_bench_%1").arg(QCoreApplication::applicationPid());
+    SweepShmPublisher publisher;
+    QString error;
+    if (!publisher.open(name, 4, points, &error)) {
+        out << "shm: " << error << "\n";
+        return false;
+    }
+
+    SweepShm::Reader reader;
+    if (!reader.open(name.toStdString())) {
+        out << "shm: the reader could not map " << name << "\n";
+        return false;
+    }
+
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(size_t(count));
+    std::atomic<bool> ready{false};
+    std::atomic<bool> stop{false};
+    bool exact = true;
+
+    const QVector<SweepData> sweeps = benchmarkSweeps(8, points);
+    QThread *thread = QThread::create([&]() {
+        SweepShm::Sweep sweep;
+        std::uint64_t last = 0;
+        ready.store(true);
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (!reader.readLatest(sweep, last)) continue;
+            latencies.push_back(SweepShm::monotonicNs() - sweep.publishNs);
+            last = sweep.publish;
+
+            // The copy must be the published sweep.
+            const SweepData& sent = sweeps[int((sweep.sweepIndex - 1) % quint64(sweeps.size()))];
+            exact = exact && int(sweep.re.size()) == sent.size()
+                    && std::equal(sweep.re.begin(), sweep.re.end(), sent.re.constBegin())
+                    && std::equal(sweep.im.begin(), sweep.im.end(), sent.im.constBegin());
+        }
+    });
+    thread->start();
+    while (!ready.load()) QThread::yieldCurrentThread();
+
+    VnaConfig cfg;
+    cfg.points = points;
+    for (int s = 0; s < count; ++s) {
+        const std::int64_t next = SweepShm::monotonicNs() + kPublishIntervalNs;
+        publisher.publish(sweeps[s % sweeps.size()], cfg);
+        while (SweepShm::monotonicNs() < next) {}
+    }
+    stop.store(true);
+    thread->wait();
+    delete thread;
+
+    std::sort(latencies.begin(), latencies.end());
+    out << QString("shm: %1 sweep(s) x %2 points, %3 read, handoff p50 %4 us, p99 %5 us, max %6 us, %7\n")
+               .arg(count)
+               .arg(points)
+               .arg(latencies.size())
+               .arg(quantileUs(latencies, 0.50), 0, 'f', 2)
+               .arg(quantileUs(latencies, 0.99), 0, 'f', 2)
+               .arg(latencies.empty() ? 0.0 : latencies.back() / 1e3, 0, 'f', 2)
+               .arg(exact ? "exact" : "MISMATCH");
+    if (QThread::idealThreadCount() < 2) {
+        out << "shm: one CPU - the reader only runs when the writer is descheduled, latencies are not meaningful\n";
+    }
+    out.flush();
+    return true;
+}
@@ -0,0 +1,16 @@
+// Shared-memory handoff benchmark (Model) module.
+// Publisher-to-reader latency of the shared-memory sweep ring (--shm-bench).
+
+#ifndef SWEEPSHMBENCHMARK_H
+#define SWEEPSHMBENCHMARK_H
+
+#include <QTextStream>
+
+
+// Publish `count` sweeps of `points` points to a temporary region, read each one
+// from another thread with SweepShm::Reader and print the p50 / p99 / max of
+// monotonicNs() - publishNs once the copy is complete. False if the region
+// could not be created.
+bool runSweepShmBenchmark(int count, int points, QTextStream& out);
+
+#endif // SWEEPSHMBENCHMARK_H
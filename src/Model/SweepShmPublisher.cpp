@@ -0,0 +1,139 @@
+// Shared-memory sweep publisher (Model) module.
+
+#include "Model/SweepShmPublisher.h"
+#include "Model/SweepShmReader.h"
+
+#include <QtGlobal>
+#include <cstring>
+#include <new>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#endif
+
+
+namespace {
+
+// Same start / stop / points give the same id, so readers can cache the frequency axis.
+quint64 gridId(double startHz, double stopHz, int points)
+{
+    quint64 hash = 1469598103934665603ull;              // FNV-1a
+    auto mix = [&hash](const void *data, size_t size) {
+        const unsigned char *p = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= p[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(&startHz, sizeof(startHz));
+    mix(&stopHz, sizeof(stopHz));
+    mix(&points, sizeof(points));
+    return hash;
+}
+
+} // namespace
+
+
+SweepShmPublisher::~SweepShmPublisher()
+{
+    close();
+}
+
+// Create (or recreate) the region. Readers find it by name and check the header.
+bool SweepShmPublisher::open(const QString& name, int slots, int maxPoints, QString* error)
+{
+    close();
+#ifdef Q_OS_UNIX
+    m_name = (name.startsWith('/') ? name : "/" + name).toLocal8Bit();
+    slots = qMax(slots, 2);
+    maxPoints = qMax(maxPoints, 2);
+
+    const size_t size = size_t(SweepShm::regionBytes(quint32(slots), quint32(maxPoints)));
+    shm_unlink(m_name.constData());             // Stale region of a crashed run.
+    const int fd = shm_open(m_name.constData(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0 || ftruncate(fd, off_t(size)) != 0) {
+        if (error) *error = QString("shm_open: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        if (fd >= 0) ::close(fd);
+        shm_unlink(m_name.constData());
+        return false;
+    }
+    void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        if (error) *error = QString("mmap: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        shm_unlink(m_name.constData());
+        return false;
+    }
+
+    // The region is zero-filled: every slot starts with seq = 0 (never published).
+    SweepShm::Header *header = new (base) SweepShm::Header;
+    header->version = SweepShm::kVersion;
+    header->slotCount = quint32(slots);
+    header->slotBytes = SweepShm::slotBytes(quint32(maxPoints));
+    header->maxPoints = quint32(maxPoints);
+    header->reserved = 0;
+    header->latest.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < slots; ++i) new (SweepShm::slotAt(base, quint32(i))) SweepShm::Slot{};
+
+    // Magic last: a reader that sees it sees a complete header.
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, SweepShm::kMagic, sizeof(SweepShm::kMagic));
+
+    m_base = base;
+    m_size = size;
+    m_publish = 0;
+    return true;
+#else
+    Q_UNUSED(name);
+    Q_UNUSED(slots);
+    Q_UNUSED(maxPoints);
+    if (error) *error = "Shared memory publishing needs a POSIX system";
+    return false;
+#endif
+}
+
+// Unmap and unlink the region (mapped readers keep their view until they unmap).
+void SweepShmPublisher::close()
+{
+#ifdef Q_OS_UNIX
+    if (m_base) {
+        munmap(m_base, m_size);
+        shm_unlink(m_name.constData());
+    }
+#endif
+    m_base = nullptr;
+    m_size = 0;
+}
+
+// Publish one sweep into the next slot of the ring. The slot's seqlock is odd while
+// it is written; `latest` moves only once the slot is complete, so a reader of the
+// newest sweep races with the writer only after slotCount further publishes.
+void SweepShmPublisher::publish(const SweepData& sweep, const VnaConfig& cfg)
+{
+    if (!m_base) return;
+    SweepShm::Header *header = static_cast<SweepShm::Header *>(m_base);
+
+    const quint64 publish = ++m_publish;
+    SweepShm::Slot *slot = SweepShm::slotAt(m_base, quint32((publish - 1) % header->slotCount));
+    const quint32 points = quint32(qMin<qint64>(sweep.size(), header->maxPoints));
+
+    slot->seq.store(2 * publish - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->sweepIndex = sweep.index;
+    slot->gridId = gridId(sweep.startHz, sweep.stopHz, int(points));
+    slot->startHz = sweep.startHz;
+    slot->stopHz = sweep.stopHz;
+    slot->configStartGHz = cfg.startFreq;
+    slot->configStopGHz = cfg.stopFreq;
+    slot->configPower = cfg.power;
+    slot->configPoints = cfg.points;
+    slot->configIfBw = cfg.ifBw;
+    slot->points = points;
+    std::memcpy(SweepShm::slotRe(slot), sweep.re.constData(), points * sizeof(double));
+    std::memcpy(SweepShm::slotIm(slot, header->maxPoints), sweep.im.constData(), points * sizeof(double));
+    slot->publishNs = SweepShm::monotonicNs();
+
+    slot->seq.store(2 * publish, std::memory_order_release);
+    header->latest.store(publish, std::memory_order_release);
+}
@@ -0,0 +1,42 @@
+// Shared-memory sweep publisher (Model) module.
+// Writes each processed sweep into a POSIX shared-memory ring for local processes.
+
+#ifndef SWEEPSHMPUBLISHER_H
+#define SWEEPSHMPUBLISHER_H
+
+#include "Interfaces/IVnaConfig.h"
+#include "Model/SweepData.h"
+
+#include <QByteArray>
+#include <QString>
+
+
+// Single writer of the region described in SweepShmReader.h (which is also the
+// reference reader for other processes). Only available on Unix.
+class SweepShmPublisher
+{
+public:
+    SweepShmPublisher() = default;
+    SweepShmPublisher(const SweepShmPublisher&) = delete;
+    SweepShmPublisher& operator=(const SweepShmPublisher&) = delete;
+    ~SweepShmPublisher();
+
+    // Create (or recreate) the region "/name" with `slots` sweeps of up to maxPoints.
+    bool open(const QString& name, int slots, int maxPoints, QString* error = nullptr);
+
+    // Unmap and unlink the region.
+    void close();
+
+    bool isOpen() const { return m_base != nullptr; }
+
+    // Publish one sweep; points above the capacity are cut. Never blocks.
+    void publish(const SweepData& sweep, const VnaConfig& cfg);
+
+private:
+    void *m_base = nullptr;
+    size_t m_size = 0;
+    QByteArray m_name;
+    quint64 m_publish = 0;          // Number of the last publish.
+};
+
+#endif // SWEEPSHMPUBLISHER_H
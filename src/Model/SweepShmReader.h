@@ -0,0 +1,219 @@
+// Shared-memory sweep layout and reference reader.
+// Header-only and Qt-free, so local analysis processes can include it on its own.
+//
+// Region layout: Header, then slotCount slots of slotBytes each. A slot is a Slot
+// followed by re[maxPoints] and im[maxPoints] (doubles).
+// The writer fills the slots round-robin, each one guarded by its own seqlock:
+// seq is odd while the slot is written and 2 * n once publish n is complete.
+// Readers never write to the region, so any number of them cannot slow the writer.
+
+#ifndef SWEEPSHMREADER_H
+#define SWEEPSHMREADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#define SWEEPSHM_POSIX 1
+#endif
+
+
+namespace SweepShm {
+
+constexpr char kMagic[8] = { 'S', '2', 'V', 'N', 'A', 'S', 'H', 'M' };
+constexpr std::uint32_t kVersion = 1;
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slotCount;
+    std::uint64_t slotBytes;
+    std::uint32_t maxPoints;
+    std::uint32_t reserved;
+    std::atomic<std::uint64_t> latest;      // Number of the newest complete publish (0 = none).
+};
+
+struct alignas(64) Slot
+{
+    std::atomic<std::uint64_t> seq;         // Seqlock: odd while written, 2 * publish when done.
+    std::uint64_t sweepIndex;               // Sweep sequence number of the application.
+    std::uint64_t gridId;                   // Same id = same frequency grid.
+    std::int64_t publishNs;                 // CLOCK_MONOTONIC at publish, for latency.
+    double startHz;
+    double stopHz;
+    double configStartGHz;                  // VnaConfig of the sweep.
+    double configStopGHz;
+    double configPower;
+    std::int32_t configPoints;
+    std::int32_t configIfBw;
+    std::uint32_t points;                   // Valid entries in re[] / im[].
+    std::uint32_t reserved;
+};
+
+// Bytes of one slot for a point capacity (kept cache-line aligned).
+inline std::uint64_t slotBytes(std::uint32_t maxPoints)
+{
+    const std::uint64_t bytes = sizeof(Slot) + 2ull * sizeof(double) * maxPoints;
+    return (bytes + 63) & ~std::uint64_t(63);
+}
+
+inline std::uint64_t regionBytes(std::uint32_t slotCount, std::uint32_t maxPoints)
+{
+    return ((sizeof(Header) + 63) & ~std::uint64_t(63)) + slotBytes(maxPoints) * slotCount;
+}
+
+inline Slot* slotAt(void* base, std::uint32_t index)
+{
+    const Header* header = static_cast<const Header*>(base);
+    char* first = static_cast<char*>(base) + ((sizeof(Header) + 63) & ~std::uint64_t(63));
+    return reinterpret_cast<Slot*>(first + header->slotBytes * index);
+}
+
+inline double* slotRe(Slot* slot) { return reinterpret_cast<double*>(slot + 1); }
+inline double* slotIm(Slot* slot, std::uint32_t maxPoints) { return slotRe(slot) + maxPoints; }
+
+// Monotonic clock shared by all processes of the host, ns.
+inline std::int64_t monotonicNs()
+{
+#ifdef SWEEPSHM_POSIX
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return std::int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+
+// One sweep copied out of the region.
+struct Sweep
+{
+    std::uint64_t publish = 0;
+    std::uint64_t sweepIndex = 0;
+    std::uint64_t gridId = 0;
+    std::int64_t publishNs = 0;
+    double startHz = 0.0;
+    double stopHz = 0.0;
+    double configStartGHz = 0.0;
+    double configStopGHz = 0.0;
+    double configPower = 0.0;
+    int configPoints = 0;
+    int configIfBw = 0;
+    std::vector<double> re;
+    std::vector<double> im;
+};
+
+
+// Reference reader: lock-free polling of the newest sweep.
+class Reader
+{
+public:
+    Reader() = default;
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    ~Reader() { close(); }
+
+    // Map the region read-only. name is the POSIX shm name, e.g. "/s2vna".
+    bool open(const std::string& name)
+    {
+#ifdef SWEEPSHM_POSIX
+        close();
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || std::uint64_t(st.st_size) < sizeof(Header)) {
+            ::close(fd);
+            return false;
+        }
+        void* base = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) return false;
+
+        m_base = base;
+        m_size = size_t(st.st_size);
+        const Header* header = static_cast<const Header*>(m_base);
+        if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion
+            || regionBytes(header->slotCount, header->maxPoints) > m_size) {
+            close();
+            return false;
+        }
+        return true;
+#else
+        (void)name;
+        return false;
+#endif
+    }
+
+    void close()
+    {
+#ifdef SWEEPSHM_POSIX
+        if (m_base) munmap(m_base, m_size);
+#endif
+        m_base = nullptr;
+        m_size = 0;
+    }
+
+    bool isOpen() const { return m_base != nullptr; }
+
+    // Number of the newest complete publish (0 = none yet).
+    std::uint64_t latest() const
+    {
+        return m_base ? static_cast<const Header*>(m_base)->latest.load(std::memory_order_acquire) : 0;
+    }
+
+    // Copy the newest sweep if it is newer than `after`. Returns false when there is
+    // nothing new. A slot overwritten during the copy is retried with the newest one.
+    bool readLatest(Sweep& out, std::uint64_t after = 0) const
+    {
+        if (!m_base) return false;
+        const Header* header = static_cast<const Header*>(m_base);
+
+        for (;;) {
+            const std::uint64_t publish = header->latest.load(std::memory_order_acquire);
+            if (publish == 0 || publish <= after) return false;
+
+            Slot* slot = slotAt(m_base, std::uint32_t((publish - 1) % header->slotCount));
+            const std::uint64_t seq1 = slot->seq.load(std::memory_order_acquire);
+            if (seq1 != 2 * publish) continue;          // Already reused by a newer publish.
+
+            const std::uint32_t points = std::min(slot->points, header->maxPoints);
+            out.publish = publish;
+            out.sweepIndex = slot->sweepIndex;
+            out.gridId = slot->gridId;
+            out.publishNs = slot->publishNs;
+            out.startHz = slot->startHz;
+            out.stopHz = slot->stopHz;
+            out.configStartGHz = slot->configStartGHz;
+            out.configStopGHz = slot->configStopGHz;
+            out.configPower = slot->configPower;
+            out.configPoints = slot->configPoints;
+            out.configIfBw = slot->configIfBw;
+            out.re.resize(points);
+            out.im.resize(points);
+            std::memcpy(out.re.data(), slotRe(slot), points * sizeof(double));
+            std::memcpy(out.im.data(), slotIm(slot, header->maxPoints), points * sizeof(double));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->seq.load(std::memory_order_relaxed) == seq1) return true;
+        }
+    }
+
+private:
+    void* m_base = nullptr;
+    size_t m_size = 0;
+};
+
+} // namespace SweepShm
+
+#endif // SWEEPSHMREADER_H
@@ -0,0 +1,173 @@
+// Touchstone reader (Model) module.
+
+#include "Model/TouchstoneReader.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+
+namespace {
+constexpr double kDegToRad = 0.017453292519943295;      // pi / 180
+
+enum class PairFormat { RI, MA, DB };
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// Next whitespace separated token of [p, end), empty at the end of the line.
+QByteArray nextToken(const char*& p, const char* end)
+{
+    while (p < end && isSpace(*p)) ++p;
+    const char* begin = p;
+    while (p < end && !isSpace(*p)) ++p;
+    return QByteArray(begin, int(p - begin));
+}
+
+bool toDouble(const char* begin, const char* end, double& value)
+{
+    if (begin < end && *begin == '+') ++begin;
+    const auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+}
+
+
+// Port count from a ".sNp" file name.
+int touchstonePorts(const QString& path)
+{
+    static const QRegularExpression re("^s(\\d+)p$", QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch match = re.match(QFileInfo(path).suffix());
+    return match.hasMatch() ? match.captured(1).toInt() : 0;
+}
+
+// Parse the file contents line by line.
+bool parseTouchstone(const char *data, qint64 size, int ports, TouchstoneNetwork& network, QString* error)
+{
+    auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    double unit = 1e9;                      // v1 defaults: GHz, S, MA, 50 Ohm.
+    PairFormat format = PairFormat::MA;
+    double referenceOhm = 50.0;
+    bool inData = true;                     // v1: data lines anywhere; v2: after [Network Data].
+    bool order21 = true;                    // 2-port pairs in S11 S21 S12 S22 order.
+    bool done = false;
+
+    std::vector<double> record;             // Numbers of the current frequency.
+    network = TouchstoneNetwork();
+
+    const char* p = data;
+    const char* end = data + size;
+    int lineNumber = 0;
+    while (p < end && !done) {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+        const char* lineEnd = eol ? eol : end;
+        const char* bang = static_cast<const char*>(std::memchr(p, '!', size_t(lineEnd - p)));
+        const char* q = p;
+        const char* stop = bang ? bang : lineEnd;
+        p = eol ? eol + 1 : end;
+        ++lineNumber;
+
+        while (q < stop && isSpace(*q)) ++q;
+        if (q == stop) continue;
+
+        if (*q == '#') {
+            ++q;
+            for (QByteArray token = nextToken(q, stop); !token.isEmpty(); token = nextToken(q, stop)) {
+                token = token.toUpper();
+                if (token == "HZ") unit = 1.0;
+                else if (token == "KHZ") unit = 1e3;
+                else if (token == "MHZ") unit = 1e6;
+                else if (token == "GHZ") unit = 1e9;
+                else if (token == "RI") format = PairFormat::RI;
+                else if (token == "MA") format = PairFormat::MA;
+                else if (token == "DB") format = PairFormat::DB;
+                else if (token == "R") referenceOhm = nextToken(q, stop).toDouble();
+                else if (token != "S") return fail(QString("Only S-parameters are supported (%1)").arg(QString(token)));
+            }
+            continue;
+        }
+
+        if (*q == '[') {
+            const char* close = static_cast<const char*>(std::memchr(q, ']', size_t(stop - q)));
+            if (!close) return fail(QString("Line %1: bad keyword").arg(lineNumber));
+            const QByteArray keyword = QByteArray(q, int(close + 1 - q)).toLower();
+            const char* arg = close + 1;
+            const QByteArray value = nextToken(arg, stop);
+
+            if (keyword == "[version]") inData = false;
+            else if (keyword == "[number of ports]") ports = value.toInt();
+            else if (keyword == "[two-port data order]") order21 = value != "12_21";
+            else if (keyword == "[network data]") inData = true;
+            else if (keyword == "[noise data]" || keyword == "[end]") done = true;
+            continue;
+        }
+
+        if (!inData) continue;
+        if (ports <= 0) return fail("Unknown number of ports (not a .sNp file)");
+
+        const size_t perRecord = size_t(1 + 2 * ports * ports);
+        for (QByteArray token = nextToken(q, stop); !token.isEmpty(); token = nextToken(q, stop)) {
+            double value = 0.0;
+            if (!toDouble(token.constData(), token.constData() + token.size(), value)) {
+                return fail(QString("Line %1: invalid number '%2'").arg(lineNumber).arg(QString(token)));
+            }
+            // v1 noise parameters follow the network data with a lower frequency.
+            if (record.empty() && !network.freqHz.isEmpty() && value * unit <= network.freqHz.last()) {
+                done = true;
+                break;
+            }
+            record.push_back(value);
+            if (record.size() < perRecord) continue;
+
+            if (network.ports == 0) {
+                network.ports = ports;
+                network.re.resize(ports * ports);
+                network.im.resize(ports * ports);
+            }
+            network.freqHz.append(record[0] * unit);
+            for (int k = 0; k < ports * ports; ++k) {
+                const double a = record[size_t(1 + 2 * k)];
+                const double b = record[size_t(2 + 2 * k)];
+                double re = a;
+                double im = b;
+                if (format != PairFormat::RI) {
+                    const double mag = format == PairFormat::DB ? std::pow(10.0, a / 20.0) : a;
+                    re = mag * std::cos(b * kDegToRad);
+                    im = mag * std::sin(b * kDegToRad);
+                }
+                // 2-port v1 (and v2 21_12): S11 S21 S12 S22.
+                const int target = (ports == 2 && order21 && (k == 1 || k == 2)) ? 3 - k : k;
+                network.re[target].append(re);
+                network.im[target].append(im);
+            }
+            record.clear();
+        }
+    }
+
+    if (!record.empty() && !done) return fail("Incomplete last data line");
+    if (network.points() == 0) return fail("No network data");
+    network.referenceOhm = referenceOhm;
+    return true;
+}
+
+// Read a Touchstone file.
+bool readTouchstone(const QString& path, TouchstoneNetwork& network, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    const QByteArray content = file.readAll();
+    return parseTouchstone(content.constData(), content.size(), touchstonePorts(path), network, error);
+}
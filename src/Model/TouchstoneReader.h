@@ -0,0 +1,42 @@
+// Touchstone reader (Model) module.
+// Loads Touchstone v1 / v2 S-parameter files (.s1p / .s2p / .sNp).
+
+#ifndef TOUCHSTONEREADER_H
+#define TOUCHSTONEREADER_H
+
+#include <QString>
+#include <QVector>
+
+
+// Network data converted to real / imaginary pairs, frequencies in Hz.
+struct TouchstoneNetwork
+{
+    int ports{0};
+    double referenceOhm{50.0};
+    QVector<double> freqHz;                 // Ascending.
+    QVector<QVector<double>> re;            // S(i, j) at index i * ports + j.
+    QVector<QVector<double>> im;
+
+    int points() const { return freqHz.size(); }
+    int index(int row, int col) const { return row * ports + col; }
+};
+
+
+// Parse the file contents. `ports` comes from the .sNp extension (0 = unknown:
+// only v2 files, which declare [Number of Ports], can be read then).
+// Comments, the option line (units, S only, RI / MA / DB, R) and the v2 keywords
+// are honoured; v1 2-port data is in S11 S21 S12 S22 order, v2 follows
+// [Two-Port Data Order]. Numbers are converted with std::from_chars.
+bool parseTouchstone(const char *data,
+                     qint64 size,
+                     int ports,
+                     TouchstoneNetwork& network,
+                     QString* error = nullptr);
+
+// Read a Touchstone file, the port count from its extension.
+bool readTouchstone(const QString& path, TouchstoneNetwork& network, QString* error = nullptr);
+
+// Port count from a ".sNp" file name, 0 if the extension does not say.
+int touchstonePorts(const QString& path);
+
+#endif // TOUCHSTONEREADER_H
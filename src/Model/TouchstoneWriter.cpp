@@ -0,0 +1,142 @@
+// Touchstone writer (Model) module.
+
+#include "Model/TouchstoneWriter.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+
+namespace {
+constexpr size_t kBufferSize = 4 << 20;         // 4 MB
+constexpr size_t kMaxLine = 512;                // Longest formatted data line.
+constexpr double kRadToDeg = 57.295779513082320876;
+}
+
+TouchstoneWriter::TouchstoneWriter()
+    : m_buffer(kBufferSize){}
+
+// Write the network to a file.
+bool TouchstoneWriter::write(const QString& path,
+                             const QVector<SweepPtr>& params,
+                             const TouchstoneOptions& options,
+                             QString* error)
+{
+    const int ports = params.size() == 4 ? 2 : 1;
+    if (params.isEmpty() || (params.size() != 1 && params.size() != 4)) {
+        if (error) *error = "Only 1-port and 2-port networks are supported";
+        return false;
+    }
+    for (const SweepPtr& p : params) {
+        if (!p || p->size() != params.first()->size()) {
+            if (error) *error = p ? "Parameters of different lengths" : "Empty sweep";
+            return false;
+        }
+    }
+    const SweepData& grid = *params.first();
+    const int points = grid.size();
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    m_used = 0;
+    appendHeader(ports, points, options);
+
+    for (int i = 0; i < points; ++i) {
+        appendNumber(grid.freqHz(i));
+
+        for (const SweepPtr& p : params) {
+            const double re = p->re[i];
+            const double im = p->im[i];
+            m_buffer[m_used++] = ' ';
+
+            switch (options.format)
+            {
+                case TouchstoneFormat::RI:
+                    appendNumber(re);
+                    m_buffer[m_used++] = ' ';
+                    appendNumber(im);
+                    break;
+
+                case TouchstoneFormat::MA:
+                    appendNumber(std::sqrt(re * re + im * im));
+                    m_buffer[m_used++] = ' ';
+                    appendNumber(std::atan2(im, re) * kRadToDeg);
+                    break;
+
+                case TouchstoneFormat::DB:
+                    appendNumber(10.0 * std::log10(std::max(re * re + im * im, 1e-24)));
+                    m_buffer[m_used++] = ' ';
+                    appendNumber(std::atan2(im, re) * kRadToDeg);
+                    break;
+            }
+        }
+        m_buffer[m_used++] = '\n';
+
+        if (!flushBuffer(file, false)) {
+            if (error) *error = file.errorString();
+            return false;
+        }
+    }
+
+    if (options.version >= 2) appendText("[End]\n");
+
+    if (!flushBuffer(file, true)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// Option line and (v2) keywords.
+void TouchstoneWriter::appendHeader(int ports, int points, const TouchstoneOptions& options)
+{
+    const char* format = options.format == TouchstoneFormat::RI ? "RI"
+                       : options.format == TouchstoneFormat::MA ? "MA" : "DB";
+    char line[256];
+
+    appendText("! Exported by S2VNA Interface\n");
+    if (options.version >= 2) {
+        appendText("[Version] 2.0\n");
+        std::snprintf(line, sizeof(line), "# Hz S %s R %g\n", format, options.referenceOhm);
+        appendText(line);
+        std::snprintf(line, sizeof(line), "[Number of Ports] %d\n", ports);
+        appendText(line);
+        if (ports == 2) appendText("[Two-Port Data Order] 21_12\n");
+        std::snprintf(line, sizeof(line), "[Number of Frequencies] %d\n", points);
+        appendText(line);
+        appendText("[Network Data]\n");
+    } else {
+        std::snprintf(line, sizeof(line), "# Hz S %s R %g\n", format, options.referenceOhm);
+        appendText(line);
+    }
+}
+
+// Locale independent formatting, 12 significant digits.
+void TouchstoneWriter::appendNumber(double value)
+{
+    char* begin = m_buffer.data() + m_used;
+    auto result = std::to_chars(begin, begin + 32, value, std::chars_format::general, 12);
+    m_used += size_t(result.ptr - begin);
+}
+
+void TouchstoneWriter::appendText(const char* text)
+{
+    const size_t len = std::strlen(text);
+    std::memcpy(m_buffer.data() + m_used, text, len);
+    m_used += len;
+}
+
+// Write the buffer when it is nearly full (or at the end).
+bool TouchstoneWriter::flushBuffer(QFile& file, bool force)
+{
+    if (!force && m_used + kMaxLine < m_buffer.size()) return true;
+    const bool ok = file.write(m_buffer.data(), qint64(m_used)) == qint64(m_used);
+    m_used = 0;
+    return ok;
+}
@@ -0,0 +1,56 @@
+// Touchstone writer (Model) module.
+// Serializes sweeps to Touchstone v1 / v2 (.s1p / .s2p) files.
+
+#ifndef TOUCHSTONEWRITER_H
+#define TOUCHSTONEWRITER_H
+
+#include "Model/SweepData.h"
+
+#include <QString>
+#include <QVector>
+#include <QFile>
+#include <vector>
+
+
+// Data format of the parameter pairs.
+enum class TouchstoneFormat
+{
+    RI,         // Real / imaginary
+    MA,         // Linear magnitude / angle, deg
+    DB          // Magnitude, dB / angle, deg
+};
+
+struct TouchstoneOptions
+{
+    int version{1};                             // 1 or 2
+    TouchstoneFormat format{TouchstoneFormat::RI};
+    double referenceOhm{50.0};
+};
+
+
+// Numbers are formatted with std::to_chars (locale independent) into a reusable
+// buffer that is flushed to the file in large blocks.
+class TouchstoneWriter
+{
+public:
+    TouchstoneWriter();
+
+    // Write the network to a file.
+    // params: ports^2 sweeps in Touchstone order (1 port: S11; 2 port: S11, S21, S12, S22),
+    // all on the grid of the first one (its startHz, stopHz and size).
+    bool write(const QString& path,
+               const QVector<SweepPtr>& params,
+               const TouchstoneOptions& options,
+               QString* error = nullptr);
+
+private:
+    void appendHeader(int ports, int points, const TouchstoneOptions& options);
+    void appendNumber(double value);
+    void appendText(const char* text);
+    bool flushBuffer(QFile& file, bool force);
+
+    std::vector<char> m_buffer;     // Reused between exports.
+    size_t m_used = 0;
+};
+
+#endif // TOUCHSTONEWRITER_H
@@ -0,0 +1,167 @@
+// Trace formats (Model) module.
+// Every format is computed from the raw complex sweep (or from another cached format,
+// e.g. group delay from the unwrapped phase) the first time it is requested.
+
+#include "Model/TraceFormats.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+constexpr double kRadToDeg = 57.295779513082320876;     // 180 / pi
+}
+
+// Human-readable format name.
+QString traceFormatName(TraceFormat format)
+{
+    switch (format)
+    {
+        case TraceFormat::LogMag:          return "Log Mag, dB";
+        case TraceFormat::LinMag:          return "Lin Mag";
+        case TraceFormat::Phase:           return "Phase, deg";
+        case TraceFormat::UnwrappedPhase:  return "Unwrapped phase, deg";
+        case TraceFormat::GroupDelay:      return "Group delay, ns";
+        case TraceFormat::Swr:             return "SWR";
+        case TraceFormat::Real:            return "Real";
+        case TraceFormat::Imag:            return "Imag";
+        case TraceFormat::Smith:           return "Smith";
+        case TraceFormat::Polar:           return "Polar";
+        case TraceFormat::Count:           break;
+    }
+    return QString();
+}
+
+// Set the new sweep and drop all cached formats.
+void TraceFormatter::setSweep(const SweepPtr& sweep)
+{
+    m_sweep = sweep;
+    m_validMask = 0;
+}
+
+// Group delay aperture, points.
+void TraceFormatter::setGroupDelayAperture(int points)
+{
+    points = std::max(points, 1);
+    if (points == m_aperture) return;
+    m_aperture = points;
+    m_validMask &= ~(1u << int(TraceFormat::GroupDelay));
+}
+
+// Values of a scalar format (computed once per sweep).
+const QVector<double>& TraceFormatter::values(TraceFormat format)
+{
+    const quint32 bit = 1u << int(format);
+    if (!(m_validMask & bit)) {
+        compute(format);
+        m_validMask |= bit;
+    }
+    return m_cache[size_t(format)];
+}
+
+// Plot points for the format.
+QVector<QPointF> TraceFormatter::points(TraceFormat format)
+{
+    QVector<QPointF> result;
+    if (!m_sweep) return result;
+
+    const QVector<double>& y = values(format);
+    const int n = y.size();
+    result.resize(n);
+    QPointF* out = result.data();
+
+    if (isComplexPlaneFormat(format)) {
+        const double* re = m_sweep->re.constData();
+        for (int i = 0; i < n; ++i) out[i] = QPointF(re[i], y[i]);
+    } else {
+        const double startMhz = m_sweep->startHz / 1e6;
+        const double stepMhz = m_sweep->stepHz() / 1e6;
+        for (int i = 0; i < n; ++i) out[i] = QPointF(startMhz + stepMhz * i, y[i]);
+    }
+    return result;
+}
+
+// Compute one format into the cache.
+void TraceFormatter::compute(TraceFormat format)
+{
+    QVector<double>& out = m_cache[size_t(format)];
+    if (!m_sweep) {
+        out.clear();
+        return;
+    }
+
+    const int n = m_sweep->size();
+    const double* re = m_sweep->re.constData();
+    const double* im = m_sweep->im.constData();
+    out.resize(n);
+    double* y = out.data();
+
+    switch (format)
+    {
+        case TraceFormat::LogMag:
+            // Clamp to 1e-24 (|S|^2) to avoid log(0) → -inf.
+            for (int i = 0; i < n; ++i)
+                y[i] = 10.0 * std::log10(std::max(re[i] * re[i] + im[i] * im[i], 1e-24));
+            break;
+
+        case TraceFormat::LinMag:
+            for (int i = 0; i < n; ++i) y[i] = std::sqrt(re[i] * re[i] + im[i] * im[i]);
+            break;
+
+        case TraceFormat::Phase:
+            for (int i = 0; i < n; ++i) y[i] = std::atan2(im[i], re[i]) * kRadToDeg;
+            break;
+
+        case TraceFormat::UnwrappedPhase: {
+            const double* wrapped = values(TraceFormat::Phase).constData();
+            double offset = 0.0;
+            for (int i = 0; i < n; ++i) {
+                if (i > 0) {
+                    const double delta = wrapped[i] - wrapped[i - 1];
+                    if (delta > 180.0) offset -= 360.0;
+                    else if (delta < -180.0) offset += 360.0;
+                }
+                y[i] = wrapped[i] + offset;
+            }
+            break;
+        }
+
+        case TraceFormat::GroupDelay: {
+            // tau = -dPhi / (360 * dF) over `aperture` steps around the point
+            // (one more step above it when odd, shifted inwards at the edges).
+            const double* phase = values(TraceFormat::UnwrappedPhase).constData();
+            const double step = m_sweep->stepHz();
+            const int span = std::min(m_aperture, n - 1);
+            for (int i = 0; i < n; ++i) {
+                const int lo = std::clamp(i - span / 2, 0, std::max(n - 1 - span, 0));
+                const int hi = lo + span;
+                const double df = step * (hi - lo);
+                y[i] = df > 0.0 ? -(phase[hi] - phase[lo]) / (360.0 * df) * 1e9 : 0.0;
+            }
+            break;
+        }
+
+        case TraceFormat::Swr: {
+            const double* mag = values(TraceFormat::LinMag).constData();
+            for (int i = 0; i < n; ++i) {
+                const double m = std::min(mag[i], 0.999999);
+                y[i] = (1.0 + m) / (1.0 - m);
+            }
+            break;
+        }
+
+        case TraceFormat::Real:
+            std::copy(re, re + n, y);
+            break;
+
+        case TraceFormat::Imag:
+        case TraceFormat::Smith:
+        case TraceFormat::Polar:
+            std::copy(im, im + n, y);
+            break;
+
+        case TraceFormat::Count:
+            out.clear();
+            break;
+    }
+}
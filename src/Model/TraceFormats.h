@@ -0,0 +1,76 @@
+// Trace formats (Model) module.
+// Derives display formats from the raw complex sweep on demand.
+
+#ifndef TRACEFORMATS_H
+#define TRACEFORMATS_H
+
+#include "Model/SweepData.h"
+
+#include <QVector>
+#include <QPointF>
+#include <QString>
+#include <array>
+
+
+// Available trace formats. Order matches the format selector in the View.
+enum class TraceFormat
+{
+    LogMag,             // 20*log10(|S|), dB
+    LinMag,             // |S|
+    Phase,              // Wrapped phase, deg
+    UnwrappedPhase,     // Unwrapped phase, deg
+    GroupDelay,         // -dPhi/dw over the aperture (span in steps), ns
+    Swr,                // (1 + |S|) / (1 - |S|)
+    Real,               // Re(S)
+    Imag,               // Im(S)
+    Smith,              // Reflection plane: x = Re(S), y = Im(S), over the impedance grid
+    Polar,              // Same points as Smith, over |S| rings and phase spokes
+    Count
+};
+
+// Human-readable format name.
+QString traceFormatName(TraceFormat format);
+
+// True for formats plotted on the complex plane instead of against frequency.
+inline bool isComplexPlaneFormat(TraceFormat format)
+{
+    return format == TraceFormat::Smith || format == TraceFormat::Polar;
+}
+
+
+// Lazily computed, per-sweep memoized derived formats.
+// Only the formats that are requested are computed; a new sweep invalidates the cache.
+class TraceFormatter
+{
+public:
+    TraceFormatter() = default;
+
+    // Set the new sweep and drop all cached formats.
+    void setSweep(const SweepPtr& sweep);
+
+    SweepPtr sweep() const { return m_sweep; }
+
+    // Group delay aperture: frequency span of the difference, in steps (>= 1).
+    void setGroupDelayAperture(int points);
+    int groupDelayAperture() const { return m_aperture; }
+
+    // Values of a scalar format (computed once per sweep).
+    // For Smith/Polar returns the y coordinates; use points() for the pairs.
+    const QVector<double>& values(TraceFormat format);
+
+    // Plot points: x = frequency, MHz (or Re / x for complex plane formats), y = value.
+    QVector<QPointF> points(TraceFormat format);
+
+    // Bit mask of the formats computed for the current sweep.
+    quint32 computedMask() const { return m_validMask; }
+
+private:
+    void compute(TraceFormat format);
+
+    SweepPtr m_sweep;
+    int m_aperture = 1;
+    quint32 m_validMask = 0;
+    std::array<QVector<double>, size_t(TraceFormat::Count)> m_cache;
+};
+
+#endif // TRACEFORMATS_H
@@ -0,0 +1,227 @@
+// Trace math (Model) module.
+
+#include "Model/TraceMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+QString traceMathName(TraceMathOp op)
+{
+    switch (op)
+    {
+        case TraceMathOp::Data:             return "Data";
+        case TraceMathOp::DataMinusMemory:  return "Data - Mem";
+        case TraceMathOp::DataDivMemory:    return "Data / Mem";
+        case TraceMathOp::DataPlusMemory:   return "Data + Mem";
+        case TraceMathOp::DbDifference:     return "dB(Data) - dB(Mem)";
+        case TraceMathOp::Count:            break;
+    }
+    return QString();
+}
+
+QString traceHoldName(TraceHold hold)
+{
+    switch (hold)
+    {
+        case TraceHold::Off:         return "Hold off";
+        case TraceHold::MaxHold:     return "Max hold";
+        case TraceHold::MinHold:     return "Min hold";
+        case TraceHold::PeakToPeak:  return "Peak-to-peak";
+        case TraceHold::Count:       break;
+    }
+    return QString();
+}
+
+// Select the hold mode and restart it.
+void TraceMath::setHold(TraceHold hold)
+{
+    m_hold = hold;
+    m_holdCount = 0;
+}
+
+// The data sweep becomes the memory trace.
+void TraceMath::storeMemory(const SweepPtr& data)
+{
+    m_memory = data;
+    m_memPoints = -1;
+}
+
+void TraceMath::clearMemory()
+{
+    m_memory.reset();
+    m_memPoints = -1;
+    m_memRe.clear();
+    m_memIm.clear();
+}
+
+// Math and hold result for the sweep.
+SweepPtr TraceMath::apply(const SweepPtr& data, bool* memoryDropped)
+{
+    if (!data || data->size() == 0 || !isActive()) return data;
+
+    const bool useMemory = m_op != TraceMathOp::Data && hasMemory();
+    if (useMemory && !prepareMemory(*data)) {
+        clearMemory();
+        if (memoryDropped) *memoryDropped = true;
+        if (!isActive()) return data;
+    }
+
+    QSharedPointer<SweepData> out(new SweepData(*data));
+    if (m_op != TraceMathOp::Data && hasMemory()) applyOperation(*out, *data);
+    if (m_hold != TraceHold::Off) applyHold(*out);
+    return out;
+}
+
+// Memory on the data grid: shared as is on the stored grid, otherwise linearly
+// interpolated once per grid. Grids reaching outside the stored range drop it.
+bool TraceMath::prepareMemory(const SweepData& data)
+{
+    const int n = data.size();
+    if (m_memPoints == n && m_memStartHz == data.startHz && m_memStopHz == data.stopHz) return true;
+
+    const SweepData& mem = *m_memory;
+    const int m = mem.size();
+    m_memStartHz = data.startHz;
+    m_memStopHz = data.stopHz;
+    m_memPoints = n;
+
+    if (m == n && mem.startHz == data.startHz && mem.stopHz == data.stopHz) {
+        m_memRe = mem.re;
+        m_memIm = mem.im;
+        return true;
+    }
+
+    const double tolerance = std::max(mem.stepHz(), 1.0) * 1e-6;
+    if (m < 2 || data.startHz < mem.startHz - tolerance || data.stopHz > mem.stopHz + tolerance) {
+        m_memPoints = -1;
+        return false;
+    }
+
+    m_memRe.resize(n);
+    m_memIm.resize(n);
+    const double memStep = mem.stepHz();
+    for (int i = 0; i < n; ++i) {
+        const double pos = std::clamp((data.freqHz(i) - mem.startHz) / memStep, 0.0, double(m - 1));
+        const int i0 = std::min(int(pos), m - 2);
+        const double t = pos - i0;
+        m_memRe[i] = mem.re[i0] + (mem.re[i0 + 1] - mem.re[i0]) * t;
+        m_memIm[i] = mem.im[i0] + (mem.im[i0 + 1] - mem.im[i0]) * t;
+    }
+    return true;
+}
+
+// out = data (op) memory, point by point.
+void TraceMath::applyOperation(SweepData& out, const SweepData& data) const
+{
+    const int n = data.size();
+    const double *a = data.re.constData();
+    const double *b = data.im.constData();
+    const double *c = m_memRe.constData();
+    const double *d = m_memIm.constData();
+    double *re = out.re.data();
+    double *im = out.im.data();
+
+    switch (m_op)
+    {
+        case TraceMathOp::DataMinusMemory:
+            for (int i = 0; i < n; ++i) {
+                re[i] = a[i] - c[i];
+                im[i] = b[i] - d[i];
+            }
+            break;
+
+        case TraceMathOp::DataPlusMemory:
+            for (int i = 0; i < n; ++i) {
+                re[i] = a[i] + c[i];
+                im[i] = b[i] + d[i];
+            }
+            break;
+
+        case TraceMathOp::DataDivMemory:
+            for (int i = 0; i < n; ++i) {
+                const double den = c[i] * c[i] + d[i] * d[i];
+                re[i] = (a[i] * c[i] + b[i] * d[i]) / den;
+                im[i] = (b[i] * c[i] - a[i] * d[i]) / den;
+            }
+            break;
+
+        case TraceMathOp::DbDifference:
+            // 20*log10|D| - 20*log10|M| = 20*log10(|D| / |M|).
+            for (int i = 0; i < n; ++i) {
+                re[i] = std::sqrt((a[i] * a[i] + b[i] * b[i]) / (c[i] * c[i] + d[i] * d[i]));
+                im[i] = 0.0;
+            }
+            break;
+
+        case TraceMathOp::Data:
+        case TraceMathOp::Count:
+            break;
+    }
+}
+
+// Update the hold with the sweep and replace the sweep by the held trace.
+void TraceMath::applyHold(SweepData& out)
+{
+    const int n = out.size();
+    if (m_holdCount == 0 || m_holdRe.size() != n || m_holdStartHz != out.startHz || m_holdStopHz != out.stopHz) {
+        m_holdRe = out.re;
+        m_holdIm = out.im;
+        m_holdMax.resize(n);
+        m_holdMin.resize(n);
+        for (int i = 0; i < n; ++i) m_holdMax[i] = m_holdMin[i] = out.re[i] * out.re[i] + out.im[i] * out.im[i];
+        m_holdStartHz = out.startHz;
+        m_holdStopHz = out.stopHz;
+        m_holdCount = 0;
+    }
+    ++m_holdCount;
+
+    double *re = out.re.data();
+    double *im = out.im.data();
+    double *holdRe = m_holdRe.data();
+    double *holdIm = m_holdIm.data();
+    double *holdMax = m_holdMax.data();
+    double *holdMin = m_holdMin.data();
+
+    switch (m_hold)
+    {
+        case TraceHold::MaxHold:
+            for (int i = 0; i < n; ++i) {
+                const double mag2 = re[i] * re[i] + im[i] * im[i];
+                const bool take = mag2 > holdMax[i];
+                holdMax[i] = take ? mag2 : holdMax[i];
+                holdRe[i] = take ? re[i] : holdRe[i];
+                holdIm[i] = take ? im[i] : holdIm[i];
+                re[i] = holdRe[i];
+                im[i] = holdIm[i];
+            }
+            break;
+
+        case TraceHold::MinHold:
+            for (int i = 0; i < n; ++i) {
+                const double mag2 = re[i] * re[i] + im[i] * im[i];
+                const bool take = mag2 < holdMin[i];
+                holdMin[i] = take ? mag2 : holdMin[i];
+                holdRe[i] = take ? re[i] : holdRe[i];
+                holdIm[i] = take ? im[i] : holdIm[i];
+                re[i] = holdRe[i];
+                im[i] = holdIm[i];
+            }
+            break;
+
+        case TraceHold::PeakToPeak:
+            // |S| ratio as a real value: Log Mag shows max - min in dB.
+            for (int i = 0; i < n; ++i) {
+                const double mag2 = re[i] * re[i] + im[i] * im[i];
+                holdMax[i] = std::max(holdMax[i], mag2);
+                holdMin[i] = std::min(holdMin[i], mag2);
+                re[i] = std::sqrt(holdMax[i] / std::max(holdMin[i], 1e-300));
+                im[i] = 0.0;
+            }
+            break;
+
+        case TraceHold::Off:
+        case TraceHold::Count:
+            break;
+    }
+}
@@ -0,0 +1,95 @@
+// Trace math (Model) module.
+// Data <-> memory operations and per-point hold on the raw complex sweep.
+
+#ifndef TRACEMATH_H
+#define TRACEMATH_H
+
+#include "Model/SweepData.h"
+
+#include <QVector>
+#include <QString>
+
+
+// Operation between the data and the memory trace. Order matches the View selector.
+enum class TraceMathOp
+{
+    Data,               // No math
+    DataMinusMemory,    // D - M (complex)
+    DataDivMemory,      // D / M (complex)
+    DataPlusMemory,     // D + M (complex)
+    DbDifference,       // dB(D) - dB(M): magnitude ratio, phase dropped
+    Count
+};
+
+// Per-point hold over the sweeps. Order matches the View selector.
+enum class TraceHold
+{
+    Off,
+    MaxHold,            // Point with the largest |S| so far
+    MinHold,            // Point with the smallest |S| so far
+    PeakToPeak,         // max |S| / min |S| (Log Mag shows the spread in dB)
+    Count
+};
+
+QString traceMathName(TraceMathOp op);
+QString traceHoldName(TraceHold hold);
+
+
+// Results are new sweeps in the same re / im layout, so every trace format, the
+// limit test and the exports work on them unchanged. The loops are branch-free
+// over separate re / im arrays so the compiler vectorizes them.
+//
+// The memory trace keeps its own grid. On a different data grid it is resampled
+// (linear re / im interpolation) once per grid, or dropped if the new grid is not
+// inside the stored range. Holds restart on every grid change.
+class TraceMath
+{
+public:
+    TraceMath() = default;
+
+    void setOperation(TraceMathOp op) { m_op = op; }
+    TraceMathOp operation() const { return m_op; }
+
+    // Select the hold mode and restart it.
+    void setHold(TraceHold hold);
+    TraceHold hold() const { return m_hold; }
+    void resetHold() { m_holdCount = 0; }
+
+    // The data sweep becomes the memory trace (shared, not copied).
+    void storeMemory(const SweepPtr& data);
+    void clearMemory();
+    bool hasMemory() const { return !m_memory.isNull(); }
+
+    // Nothing to do: apply() returns the input sweep.
+    bool isActive() const { return (m_op != TraceMathOp::Data && hasMemory()) || m_hold != TraceHold::Off; }
+
+    // Math and hold result for the sweep. memoryDropped is set when the memory
+    // trace had to be dropped because the grid left its range.
+    SweepPtr apply(const SweepPtr& data, bool* memoryDropped = nullptr);
+
+private:
+    // Memory on the data grid (resampled on grid change). False if dropped.
+    bool prepareMemory(const SweepData& data);
+    void applyOperation(SweepData& out, const SweepData& data) const;
+    void applyHold(SweepData& out);
+
+    TraceMathOp m_op = TraceMathOp::Data;
+    TraceHold m_hold = TraceHold::Off;
+
+    SweepPtr m_memory;                  // As stored.
+    QVector<double> m_memRe;            // On the current data grid.
+    QVector<double> m_memIm;
+    double m_memStartHz = 0.0;
+    double m_memStopHz = 0.0;
+    int m_memPoints = -1;               // -1 = not prepared.
+
+    QVector<double> m_holdRe;
+    QVector<double> m_holdIm;
+    QVector<double> m_holdMax;          // |S|^2
+    QVector<double> m_holdMin;          // |S|^2 (peak-to-peak)
+    double m_holdStartHz = 0.0;
+    double m_holdStopHz = 0.0;
+    int m_holdCount = 0;
+};
+
+#endif // TRACEMATH_H
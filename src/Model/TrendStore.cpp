@@ -0,0 +1,316 @@
+// Trend store (Model) module.
+// Appends go through one buffered QFile per level; queries use separate read handles
+// and binary search level 0 for the time range (O(log n) small reads), then read one
+// contiguous run of records from the coarsest level that still resolves the range.
+
+#include "Model/TrendStore.h"
+
+#include <QDir>
+#include <QMutexLocker>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+// Parse "1.5,2.0-2.5" (GHz).
+bool parseTrendChannels(const QString& spec, QVector<TrendChannel>* channels, QString* error)
+{
+    QVector<TrendChannel> result;
+    const QStringList items = spec.split(',', Qt::SkipEmptyParts);
+
+    for (const QString& raw : items) {
+        const QString item = raw.trimmed();
+        const QStringList range = item.split('-', Qt::SkipEmptyParts);
+        bool ok1 = false;
+        bool ok2 = false;
+        TrendChannel channel;
+
+        if (range.size() == 1) {
+            channel.startHz = channel.stopHz = range[0].toDouble(&ok1) * 1e9;
+            ok2 = true;
+        } else if (range.size() == 2) {
+            channel.startHz = range[0].toDouble(&ok1) * 1e9;
+            channel.stopHz = range[1].toDouble(&ok2) * 1e9;
+        }
+
+        if (!ok1 || !ok2 || channel.stopHz < channel.startHz) {
+            if (error) *error = QString("Invalid trend channel '%1'").arg(item);
+            return false;
+        }
+        channel.name = item + " GHz";
+        result.append(channel);
+    }
+
+    if (result.isEmpty()) {
+        if (error) *error = "No trend channels";
+        return false;
+    }
+    *channels = result;
+    return true;
+}
+
+// Per channel min / max on the sweep's grid.
+void trendChannelValues(const SweepData& sweep,
+                        const QVector<double>& values,
+                        const QVector<TrendChannel>& channels,
+                        float *lo,
+                        float *hi)
+{
+    const int n = std::min(values.size(), sweep.size());
+    const double step = sweep.stepHz();
+
+    for (int c = 0; c < channels.size(); ++c) {
+        const TrendChannel& channel = channels[c];
+        int first = 0;
+        int last = n - 1;
+        if (step > 0.0) {
+            if (channel.startHz == channel.stopHz) {
+                first = last = int(std::lround((channel.startHz - sweep.startHz) / step));
+            } else {
+                first = int(std::ceil((channel.startHz - sweep.startHz) / step - 1e-9));
+                last = int(std::floor((channel.stopHz - sweep.startHz) / step + 1e-9));
+            }
+            first = std::max(first, 0);
+            last = std::min(last, n - 1);
+        }
+
+        lo[c] = hi[c] = std::numeric_limits<float>::quiet_NaN();
+        if (first <= last) {
+            const auto range = std::minmax_element(values.constBegin() + first, values.constBegin() + last + 1);
+            lo[c] = float(*range.first);
+            hi[c] = float(*range.second);
+        }
+    }
+}
+
+
+TrendStore::~TrendStore()
+{
+    close();
+}
+
+// Start a new recording: every level file is truncated.
+bool TrendStore::open(const QString& dir, const QVector<TrendChannel>& channels, QString* error)
+{
+    close();
+    QMutexLocker locker(&m_mutex);
+
+    if (!QDir().mkpath(dir)) {
+        if (error) *error = QString("Cannot create %1").arg(dir);
+        return false;
+    }
+
+    m_dir = dir;
+    m_channels = channels;
+    for (int level = 0; level < kMaxLevels; ++level) {
+        const QString path = QString("%1/trend_L%2.bin").arg(dir).arg(level);
+        m_writers[level].reset(new QFile(path));
+        m_readers[level].reset(new QFile(path));
+        if (!m_writers[level]->open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || !m_readers[level]->open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            if (error) *error = m_writers[level]->errorString();
+            locker.unlock();
+            close();
+            return false;
+        }
+        m_counts[level] = 0;
+        resetRecord(m_partial[level]);
+    }
+    m_firstMs = m_lastMs = 0;
+    return true;
+}
+
+void TrendStore::close()
+{
+    QMutexLocker locker(&m_mutex);
+    for (int level = 0; level < kMaxLevels; ++level) {
+        m_writers[level].reset();
+        m_readers[level].reset();
+        m_counts[level] = 0;
+    }
+    m_channels.clear();
+}
+
+// Append one sweep and carry completed buckets up the pyramid.
+void TrendStore::append(qint64 timeMs, const float *lo, const float *hi)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_writers[0]) return;
+
+    const int channels = m_channels.size();
+    Record record;
+    record.t0 = record.t1 = timeMs;
+    record.lo = QVector<float>(lo, lo + channels);
+    record.hi = QVector<float>(hi, hi + channels);
+
+    if (m_counts[0] == 0) m_firstMs = timeMs;
+    m_lastMs = timeMs;
+    writeRecord(0, record);
+
+    for (int level = 1; level < kMaxLevels; ++level) {
+        Record& partial = m_partial[level];
+        merge(partial, record);
+        if (partial.count < kFanout) break;
+
+        writeRecord(level, partial);
+        record = partial;
+        resetRecord(partial);
+    }
+}
+
+// Buckets covering [fromMs, toMs] from the coarsest level with <= maxBuckets of them.
+TrendSeries TrendStore::query(qint64 fromMs, qint64 toMs, int maxBuckets)
+{
+    QMutexLocker locker(&m_mutex);
+    TrendSeries out;
+    out.channels = m_channels;
+    out.firstMs = m_firstMs;
+    out.lastMs = m_lastMs;
+    if (!m_writers[0] || m_counts[0] == 0) return out;
+
+    // Make the buffered appends visible to the read handles.
+    if (m_dirty) {
+        for (auto& writer : m_writers) writer->flush();
+        m_dirty = false;
+    }
+
+    const qint64 first = lowerBound(fromMs, false);
+    const qint64 last = lowerBound(toMs, true);             // One past the range.
+    if (last <= first) return out;
+
+    maxBuckets = std::max(maxBuckets, 1);
+    int level = 0;
+    qint64 scale = 1;
+    while (level + 1 < kMaxLevels && (last - first) / scale > maxBuckets) {
+        ++level;
+        scale *= kFanout;
+    }
+
+    const qint64 begin = first / scale;
+    const qint64 end = (last + scale - 1) / scale;
+    const qint64 complete = std::min(end, m_counts[level]);
+    out.level = level;
+    if (complete > begin) readRecords(level, begin, complete - begin, out);
+
+    // The newest bucket is still open: merge the partial buckets below this level.
+    if (end > m_counts[level] && level > 0) {
+        Record tail;
+        resetRecord(tail);
+        for (int k = level; k >= 1; --k) {
+            if (m_partial[k].count > 0) merge(tail, m_partial[k]);
+        }
+        if (tail.count > 0) {
+            out.startMs.append(tail.t0);
+            out.stopMs.append(tail.t1);
+            out.lo += tail.lo;
+            out.hi += tail.hi;
+        }
+    }
+    return out;
+}
+
+void TrendStore::resetRecord(Record& r) const
+{
+    r.t0 = r.t1 = 0;
+    r.count = 0;
+    r.lo.fill(0.0f, m_channels.size());
+    r.hi.fill(0.0f, m_channels.size());
+}
+
+// Extend a bucket by a newer record.
+void TrendStore::merge(Record& into, const Record& from) const
+{
+    if (into.count == 0) {
+        into.t0 = from.t0;
+        into.lo = from.lo;
+        into.hi = from.hi;
+    } else {
+        float *lo = into.lo.data();
+        float *hi = into.hi.data();
+        for (int c = 0; c < m_channels.size(); ++c) {
+            lo[c] = std::fmin(lo[c], from.lo[c]);       // NaN (channel off grid) is ignored.
+            hi[c] = std::fmax(hi[c], from.hi[c]);
+        }
+    }
+    into.t1 = from.t1;
+    ++into.count;
+}
+
+// Append a record to the level file: t0, t1, then lo / hi pairs.
+void TrendStore::writeRecord(int level, const Record& r)
+{
+    m_buffer.resize(recordBytes());
+    char *p = m_buffer.data();
+    std::memcpy(p, &r.t0, sizeof(qint64));
+    std::memcpy(p + sizeof(qint64), &r.t1, sizeof(qint64));
+    float *values = reinterpret_cast<float *>(p + 2 * sizeof(qint64));
+    for (int c = 0; c < m_channels.size(); ++c) {
+        values[2 * c] = r.lo[c];
+        values[2 * c + 1] = r.hi[c];
+    }
+    m_writers[level]->write(m_buffer);
+    ++m_counts[level];
+    m_dirty = true;
+}
+
+// Read `count` records starting at `first` into the series.
+bool TrendStore::readRecords(int level, qint64 first, qint64 count, TrendSeries& out)
+{
+    const int bytes = recordBytes();
+    QFile *reader = m_readers[level].get();
+    if (!reader->seek(first * bytes)) return false;
+
+    m_buffer.resize(int(count * bytes));
+    if (reader->read(m_buffer.data(), m_buffer.size()) != m_buffer.size()) return false;
+
+    const int channels = m_channels.size();
+    out.startMs.reserve(out.startMs.size() + int(count) + 1);
+    out.stopMs.reserve(out.stopMs.size() + int(count) + 1);
+    out.lo.reserve(out.lo.size() + int(count + 1) * channels);
+    out.hi.reserve(out.hi.size() + int(count + 1) * channels);
+
+    const char *p = m_buffer.constData();
+    for (qint64 i = 0; i < count; ++i, p += bytes) {
+        qint64 t0;
+        qint64 t1;
+        std::memcpy(&t0, p, sizeof(qint64));
+        std::memcpy(&t1, p + sizeof(qint64), sizeof(qint64));
+        out.startMs.append(t0);
+        out.stopMs.append(t1);
+
+        const float *values = reinterpret_cast<const float *>(p + 2 * sizeof(qint64));
+        for (int c = 0; c < channels; ++c) {
+            out.lo.append(values[2 * c]);
+            out.hi.append(values[2 * c + 1]);
+        }
+    }
+    return true;
+}
+
+// Time of one level-0 record (one sweep: start == stop).
+qint64 TrendStore::readTime(qint64 index)
+{
+    qint64 t = 0;
+    QFile *reader = m_readers[0].get();
+    if (reader->seek(index * recordBytes())) reader->read(reinterpret_cast<char *>(&t), sizeof(t));
+    return t;
+}
+
+// First level-0 record with time >= timeMs (or > timeMs when strict).
+qint64 TrendStore::lowerBound(qint64 timeMs, bool strict)
+{
+    qint64 lo = 0;
+    qint64 hi = m_counts[0];
+    while (lo < hi) {
+        const qint64 mid = lo + (hi - lo) / 2;
+        const qint64 t = readTime(mid);
+        if (t < timeMs || (strict && t == timeMs)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
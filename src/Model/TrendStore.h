@@ -0,0 +1,116 @@
+// Trend store (Model) module.
+// Disk-backed per-sweep scalar values with a multi-resolution min/max pyramid.
+
+#ifndef TRENDSTORE_H
+#define TRENDSTORE_H
+
+#include "Model/SweepData.h"
+
+#include <QString>
+#include <QVector>
+#include <QFile>
+#include <QMutex>
+#include <QMetaType>
+#include <array>
+#include <memory>
+
+
+// A tracked value: a marker (startHz == stopHz) or the min/max of a band.
+struct TrendChannel
+{
+    QString name;
+    double startHz{0.0};
+    double stopHz{0.0};
+};
+
+// Parse "1.5,2.0-2.5" (GHz): single frequencies are markers, ranges are bands.
+bool parseTrendChannels(const QString& spec, QVector<TrendChannel>* channels, QString* error = nullptr);
+
+// Per channel min / max of values (one per sweep point) on the sweep's grid: a
+// marker takes the nearest point, NaN where a channel is outside the sweep.
+void trendChannelValues(const SweepData& sweep,
+                        const QVector<double>& values,
+                        const QVector<TrendChannel>& channels,
+                        float *lo,
+                        float *hi);
+
+
+// Query result: buckets of one pyramid level, oldest first.
+// lo / hi are indexed [bucket * channels + channel].
+struct TrendSeries
+{
+    QVector<TrendChannel> channels;
+    int level{0};                   // 0 = single sweeps.
+    QVector<qint64> startMs;        // First sweep of the bucket.
+    QVector<qint64> stopMs;         // Last sweep of the bucket.
+    QVector<float> lo;
+    QVector<float> hi;
+    qint64 firstMs{0};              // Whole recording.
+    qint64 lastMs{0};
+
+    int size() const { return startMs.size(); }
+};
+
+Q_DECLARE_METATYPE(TrendSeries)
+
+
+// Level 0 holds one record per sweep; each record of level k > 0 is the min/max of
+// kFanout records of level k - 1. Every level is an append-only file of fixed-size
+// records, so an append is O(1) amortized (1 + 1/16 + 1/256 + ... record writes),
+// and a query reads at most maxBuckets records of the level that fits the range.
+// Thread-safe: appended from the pipeline, queried from the main thread.
+class TrendStore
+{
+public:
+    static constexpr int kFanout = 16;
+    static constexpr int kMaxLevels = 8;        // 16^7 sweeps per top bucket.
+
+    TrendStore() = default;
+    ~TrendStore();
+
+    // Start a new recording in `dir` (files trend_L<k>.bin).
+    bool open(const QString& dir, const QVector<TrendChannel>& channels, QString* error = nullptr);
+    void close();
+
+    const QVector<TrendChannel>& channels() const { return m_channels; }
+
+    // Append one sweep: per channel lo / hi values (equal for markers).
+    void append(qint64 timeMs, const float *lo, const float *hi);
+
+    // Buckets covering [fromMs, toMs], at most maxBuckets (plus the incomplete tail).
+    TrendSeries query(qint64 fromMs, qint64 toMs, int maxBuckets);
+
+private:
+    // Aggregated record of one level (file layout: t0, t1, then lo/hi per channel).
+    struct Record
+    {
+        qint64 t0 = 0;
+        qint64 t1 = 0;
+        QVector<float> lo;
+        QVector<float> hi;
+        int count = 0;              // Child records merged (partial buckets only).
+    };
+
+    void resetRecord(Record& r) const;
+    void merge(Record& into, const Record& from) const;
+    void writeRecord(int level, const Record& r);
+    bool readRecords(int level, qint64 first, qint64 count, TrendSeries& out);
+    qint64 readTime(qint64 index);
+    // First level-0 record with time >= timeMs (> timeMs when strict).
+    qint64 lowerBound(qint64 timeMs, bool strict);
+    int recordBytes() const { return int(2 * sizeof(qint64) + 2 * sizeof(float) * m_channels.size()); }
+
+    QMutex m_mutex;
+    QString m_dir;
+    QVector<TrendChannel> m_channels;
+    std::array<std::unique_ptr<QFile>, kMaxLevels> m_writers;
+    std::array<std::unique_ptr<QFile>, kMaxLevels> m_readers;
+    std::array<qint64, kMaxLevels> m_counts{};          // Complete records per level.
+    std::array<Record, kMaxLevels> m_partial;           // Incomplete bucket per level (> 0).
+    QByteArray m_buffer;                                 // Record encode / decode buffer.
+    qint64 m_firstMs = 0;
+    qint64 m_lastMs = 0;
+    bool m_dirty = false;                                // Written since the last flush.
+};
+
+#endif // TRENDSTORE_H
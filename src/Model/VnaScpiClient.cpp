@@ -2,12 +2,38 @@
 // Works in a thread with QTcpSocket, sending/receiving SCPI commands.
 
 #include "Model/VnaScpiClient.h"
+#include "Model/Metrics.h"
 
+#include <algorithm>
+
+
+namespace {
+// A raw query unanswered for this long is dropped, so later replies stay in step.
+constexpr int kRawReplyTimeoutMs = 2000;
+
+// True if the command line holds a query: a '?' outside quoted string parameters.
+bool isQuery(const QByteArray& line)
+{
+    char quote = 0;
+    for (const char c : line) {
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '?') {
+            return true;
+        }
+    }
+    return false;
+}
+}
 
 // !! Runs in a separate thread. !!
 ScpiClient::ScpiClient(QObject *parent)
     : IModel(parent)
 {
+    m_clock.start();
+
     // Create a socket.
     m_socket = new QTcpSocket(this);
 
@@ -15,6 +41,17 @@ ScpiClient::ScpiClient(QObject *parent)
     connect(m_socket, &QTcpSocket::connected, this, &ScpiClient::onConnected);
     connect(m_socket, &QTcpSocket::disconnected, this, &ScpiClient::onDisconnected);
     connect(m_socket, &QTcpSocket::readyRead, this, &ScpiClient::onReadyRead);
+
+    // Replay transport (used only when a replay file is set).
+    m_replay = new ScpiReplayTransport(this);
+    connect(m_replay, &ScpiReplayTransport::chunkReady, this, &ScpiClient::handleIncoming);
+    connect(m_replay, &ScpiReplayTransport::finished, this, &ScpiClient::onReplayFinished);
+
+    // Raw reply timeout (armed while a raw query is the oldest one pending).
+    m_replyTimer = new QTimer(this);
+    m_replyTimer->setSingleShot(true);
+    m_replyTimer->setInterval(kRawReplyTimeoutMs);
+    connect(m_replyTimer, &QTimer::timeout, this, &ScpiClient::onReplyTimeout);
 }
 
 // Destructor, closing the socket connection.
@@ -25,22 +62,72 @@ ScpiClient::~ScpiClient()
     }
 }
 
-// Connecting to a socket via host and port.
+// Capture / replay selection, applied on the next connectTo().
+void ScpiClient::setTransportOptions(const ScpiTransportOptions& options)
+{
+    m_options = options;
+}
+
+// Connecting to a socket via host and port (or starting the replay).
 void ScpiClient::connectTo(const QString& host, quint16 port)
 {
+    if (!m_options.capturePath.isEmpty() && !m_capture.isOpen()) {
+        m_capture.open(m_options.capturePath);
+    }
+
+    if (!m_options.replayPath.isEmpty()) {
+        if (m_replay->open(m_options.replayPath, m_options.replayRealTime)) {
+            m_replay->start();
+            onConnected();
+        }
+        return;
+    }
     m_socket->connectToHost(host, port);
 }
 
 // Checking the connection status to the device.
 bool ScpiClient::isConnected() const
 {
+    if (!m_options.replayPath.isEmpty()) return m_replay->isRunning();
     return m_socket->state() == QAbstractSocket::ConnectedState;
 }
 
 // Forcefully reset the socket connection.
 void ScpiClient::abort()
 {
+    m_replay->stop();
     m_socket->abort();
+    m_pending.clear();
+    m_replyTimer->stop();
+    m_rxBuffer.clear();
+    m_rxScanned = 0;
+    m_sweepParser.reset();
+    m_sweepParseNs = 0;
+    m_firstByteNs = 0;
+}
+
+// Replay finished: behave like a closed connection.
+void ScpiClient::onReplayFinished()
+{
+    emit disconnected();
+}
+
+// Send a command to the socket (or replay transport), capture if enabled.
+void ScpiClient::send(const QByteArray& command)
+{
+    Metrics::instance().bytesWritten.add(command.size());
+    m_capture.record(ScpiCaptureRecord::Direction::Write, command);
+    if (m_replay->isRunning()) {
+        m_replay->notifyWrite(command);
+    } else {
+        m_socket->write(command);
+    }
+}
+
+// Flush written commands.
+void ScpiClient::flush()
+{
+    if (!m_replay->isRunning()) m_socket->flush();
 }
 
 // Successful connection to socket.
@@ -52,18 +139,24 @@ void ScpiClient::onConnected()
 // Socket disconnect warning.
 void ScpiClient::onDisconnected()
 {
+    m_pending.clear();
+    m_replyTimer->stop();
+    m_rxBuffer.clear();
+    m_rxScanned = 0;
+    m_sweepParser.reset();
+    m_sweepParseNs = 0;
+    m_firstByteNs = 0;
     emit disconnected();
 }
 
 // Method for getting current socket data.
 void ScpiClient::requestConfiguration()
 {
-    m_socket->write(":SENS:FREQ:STAR?\n");
-    m_socket->write(":SENS:FREQ:STOP?\n");
-    m_socket->write(":SENS:SWE:POIN?\n");
-    m_socket->write(":SOUR:POW?\n");
-    m_socket->write(":SENS:BAND?\n");
-    m_socket->flush();
+    // All queries in one write (one capture record per request).
+    // Replies are queued before the write: a replay answers within send().
+    m_pending.enqueue({ PendingReply::Kind::Configuration, 5, 0, m_clock.nsecsElapsed() });
+    send(":SENS:FREQ:STAR?\n:SENS:FREQ:STOP?\n:SENS:SWE:POIN?\n:SOUR:POW?\n:SENS:BAND?\n");
+    flush();
 }
 
 // Method for requesting data from view fields to a socket.
@@ -79,41 +172,175 @@ void ScpiClient::setConfiguration(double startFreq,
     QString powerStr  = QString("%1E9").arg(power, 0, 'f', 2);
 
     // SCPI requests in socket.
-    m_socket->write(QString(":SENS:FREQ:STAR %1\n").arg(startStr).toUtf8());
-    m_socket->write(QString(":SENS:FREQ:STOP %1\n").arg(stopStr).toUtf8());
-    m_socket->write(QString(":SENS:SWE:POIN %1\n").arg(points).toUtf8());
-    m_socket->write(QString(":SOUR:POW %1\n").arg(powerStr).toUtf8());
-    m_socket->write(QString(":SENS:BAND %1\n").arg(ifBw).toUtf8());
-    m_socket->flush();
+    send(QString(":SENS:FREQ:STAR %1\n"
+                 ":SENS:FREQ:STOP %2\n"
+                 ":SENS:SWE:POIN %3\n"
+                 ":SOUR:POW %4\n"
+                 ":SENS:BAND %5\n")
+             .arg(startStr, stopStr).arg(points).arg(powerStr).arg(ifBw).toUtf8());
+    flush();
 }
 
 // Receiving data for the desired graph from a socket.
 void ScpiClient::requestSParamsGraph()
 {
-    m_socket->write(":FORM:DATA ASC\n");
-    m_socket->write(":INIT:IMM\n");
-    m_socket->write(":CALC:DATA:SDAT?\n");
-    m_socket->flush();
+    m_pending.enqueue({ PendingReply::Kind::Sweep, 1, 0, m_clock.nsecsElapsed() });
+    send(":FORM:DATA ASC\n:INIT:IMM\n:CALC:DATA:SDAT?\n");
+    flush();
+}
+
+// Trigger one sweep for a test sequence step. *OPC? answers when the sweep is done,
+// so the next step can be configured while this sweep's data is still transferring.
+void ScpiClient::requestSequenceSweep(quint64 tag)
+{
+    m_pending.enqueue({ PendingReply::Kind::Completion, 1, tag, m_clock.nsecsElapsed() });
+    m_pending.enqueue({ PendingReply::Kind::Sweep, 1, tag, m_clock.nsecsElapsed() });
+    send(":FORM:DATA ASC\n:INIT:IMM\n*OPC?\n:CALC:DATA:SDAT?\n");
+    flush();
+}
+
+// Send a raw SCPI command line on behalf of an external client.
+void ScpiClient::sendRaw(quint64 tag, const QByteArray& commandLine)
+{
+    QByteArray line = commandLine.trimmed();
+    if (line.isEmpty()) return;
+
+    if (isQuery(line)) {
+        m_pending.enqueue({ PendingReply::Kind::Raw, 1, tag, m_clock.nsecsElapsed() });
+        if (m_pending.size() == 1) armReplyTimeout();
+    }
+    send(line + '\n');
+    flush();
 }
 
 // If data has arrived in the socket, we receive it.
 void ScpiClient::onReadyRead()
 {
-    QString rawData = m_socket->readAll().trimmed();
-    QStringList lines = rawData.split('\n', Qt::SkipEmptyParts);
-
-    // Extracting data.
-    if (lines.size() >= 5) {
-        emit configurationReceived(
-            lines[0].toDouble(),
-            lines[1].toDouble(),
-            lines[2].toInt(),
-            lines[3].toDouble(),
-            lines[4].toDouble()
-            );
+    handleIncoming(m_socket->readAll());
+}
+
+// Process a received chunk (socket or replay).
+void ScpiClient::handleIncoming(const QByteArray& chunk)
+{
+    Metrics::instance().bytesRead.add(chunk.size());
+    m_capture.record(ScpiCaptureRecord::Direction::Read, chunk);
+
+    m_rxBuffer.append(chunk);
+    dispatchReplies();
+}
+
+// Emit the complete replies from the receive buffer.
+// A reply may arrive in many chunks, and one chunk may hold several replies.
+void ScpiClient::dispatchReplies()
+{
+    while (!m_pending.isEmpty()) {
+        const PendingReply& reply = m_pending.head();
+
+        // Find the end of the reply's last line. Single-line replies (sweeps) resume
+        // the search where the previous chunk ended to stay linear in the reply size.
+        int end = -1;
+        const int scanned = reply.lines == 1 ? m_rxScanned : 0;
+        int from = scanned;
+        for (int line = 0; line < reply.lines; ++line) {
+            end = m_rxBuffer.indexOf('\n', from);
+            if (end < 0) break;
+            from = end + 1;
+        }
+
+        // Sweep values are converted as soon as their bytes arrive, so only the
+        // last chunk is left to parse when the terminating '\n' shows up.
+        if (reply.kind == PendingReply::Kind::Sweep) {
+            if (m_firstByteNs == 0 && !m_rxBuffer.isEmpty()) m_firstByteNs = m_clock.nsecsElapsed();
+            QElapsedTimer parseTimer;
+            parseTimer.start();
+            const int stop = end < 0 ? m_rxBuffer.size() : end;
+            m_sweepParser.feed(m_rxBuffer.constData() + scanned, stop - scanned);
+            m_sweepParseNs += parseTimer.nsecsElapsed();
+        }
+
+        if (end < 0) {
+            if (reply.lines == 1) m_rxScanned = m_rxBuffer.size();
+            return;
+        }
+
+        const QByteArray data = m_rxBuffer.left(end + 1).trimmed();
+        m_rxBuffer.remove(0, end + 1);
+        m_rxScanned = 0;
+        const PendingReply done = m_pending.dequeue();
+        armReplyTimeout();
+        const qint64 startNs = std::max(done.sentNs, m_lastReplyNs);
+        m_lastReplyNs = m_clock.nsecsElapsed();
+
+        switch (done.kind)
+        {
+            case PendingReply::Kind::Configuration: {
+                const QList<QByteArray> lines = data.split('\n');
+                if (lines.size() >= 5) {
+                    emit configurationReceived(
+                        lines[0].trimmed().toDouble(),
+                        lines[1].trimmed().toDouble(),
+                        lines[2].trimmed().toInt(),
+                        lines[3].trimmed().toDouble(),
+                        lines[4].trimmed().toDouble()
+                        );
+                    m_sweepParser.begin(lines[2].trimmed().toInt());
+                }
+                break;
+            }
+
+            case PendingReply::Kind::Sweep: {
+                // Graph data: raw bytes for the fan-out, converted sweep for the pipeline.
+                // Sequence sweeps wait for *OPC? first, so only free-running sweeps are timed.
+                const QSharedPointer<SweepData> values = m_sweepParser.finish();
+                if (done.tag == 0) {
+                    values->acquireNs = std::max<qint64>(m_firstByteNs - startNs, 1);
+                    values->transferNs = m_lastReplyNs - m_firstByteNs;
+                    values->parseNs = m_sweepParseNs;
+                }
+                const SweepPtr sweep = values;
+                Metrics::instance().parseNs.record(m_sweepParseNs);
+                m_sweepParseNs = 0;
+                m_firstByteNs = 0;
+                emit sweepBytesReceived(data);
+                if (done.tag != 0) emit taggedSweepReceived(done.tag, sweep);
+                emit sParametersReceived(sweep);
+                break;
+            }
+
+            case PendingReply::Kind::Completion:
+                emit sweepCompleted(done.tag);
+                break;
+
+            case PendingReply::Kind::Raw:
+                emit rawReplyReceived(done.tag, data);
+                break;
+        }
     }
-    else {
-        // Graph data.
-        emit sParametersReceived(rawData);
+
+    // Nothing expected: drop unsolicited data.
+    m_rxBuffer.clear();
+    m_rxScanned = 0;
+}
+
+// Restart the raw reply timeout if the oldest pending reply is a raw one.
+void ScpiClient::armReplyTimeout()
+{
+    if (!m_pending.isEmpty() && m_pending.head().kind == PendingReply::Kind::Raw) {
+        m_replyTimer->start();
+    } else {
+        m_replyTimer->stop();
     }
 }
+
+// A raw query got no reply (e.g. an unknown command the instrument ignored).
+// Drop it and the partial data, so the replies behind it are not shifted by one.
+void ScpiClient::onReplyTimeout()
+{
+    if (m_pending.isEmpty() || m_pending.head().kind != PendingReply::Kind::Raw) return;
+
+    const PendingReply lost = m_pending.dequeue();
+    m_rxBuffer.clear();
+    m_rxScanned = 0;
+    emit rawReplyReceived(lost.tag, "ERR no reply");
+    armReplyTimeout();
+}
@@ -5,10 +5,15 @@
 #define VNASCPICLIENT_H
 
 #include "Interfaces/IVnaModel.h"
+#include "Model/ScpiCapture.h"
+#include "Model/ScpiReplayTransport.h"
+#include "Model/StreamingSweepParser.h"
 
 #include <QTimer>
 #include <QTcpSocket>
 #include <QThread>
+#include <QQueue>
+#include <QElapsedTimer>
 
 
 // !! Runs in a separate thread. !!
@@ -36,6 +41,13 @@ public:
 
     void requestSParamsGraph() override;
 
+    void requestSequenceSweep(quint64 tag) override;
+
+    void sendRaw(quint64 tag, const QByteArray& commandLine) override;
+
+    // Capture / replay selection, applied on the next connectTo().
+    void setTransportOptions(const ScpiTransportOptions& options);
+
 private slots:
     // Successful connection to socket.
     void onConnected();
@@ -46,8 +58,54 @@ private slots:
     // Get contents from socket (data/graph).
     void onReadyRead();
 
+    // Replay finished: behave like a closed connection.
+    void onReplayFinished();
+
+    // A raw query got no reply: drop it and resynchronize.
+    void onReplyTimeout();
+
 private:
+    // Send a command to the socket (or replay transport), capture if enabled.
+    void send(const QByteArray& command);
+    // Flush written commands.
+    void flush();
+    // Process a received chunk (socket or replay).
+    void handleIncoming(const QByteArray& chunk);
+
+    // Replies expected from the instrument, in request order.
+    // The S2VNA answers queries in order, one '\n'-terminated line per query line.
+    struct PendingReply
+    {
+        enum class Kind { Configuration, Sweep, Completion, Raw };
+        Kind kind;
+        int lines;              // Reply lines to collect.
+        quint64 tag;            // Raw reply routing tag / sequence step tag.
+        qint64 sentNs;          // Request write time (m_clock).
+    };
+    // Emit the complete replies from the receive buffer.
+    void dispatchReplies();
+    // Restart the raw reply timeout if the oldest pending reply is a raw one.
+    void armReplyTimeout();
+
     QTcpSocket *m_socket = nullptr;
+    QQueue<PendingReply> m_pending;
+    QByteArray m_rxBuffer;
+    int m_rxScanned = 0;        // Bytes of m_rxBuffer already searched for '\n'.
+    QTimer *m_replyTimer = nullptr;
+
+    // Sweep reply converted while it arrives (bytes up to m_rxScanned are consumed).
+    StreamingSweepParser m_sweepParser;
+    qint64 m_sweepParseNs = 0;
+
+    // Sweep timing: the instrument starts a request once the previous reply is out.
+    QElapsedTimer m_clock;
+    qint64 m_lastReplyNs = 0;   // Previous reply complete.
+    qint64 m_firstByteNs = 0;   // First byte of the current sweep reply (0 = none yet).
+
+    // Capture / replay.
+    ScpiTransportOptions m_options;
+    ScpiCaptureWriter m_capture;
+    ScpiReplayTransport *m_replay = nullptr;
 
 };
 
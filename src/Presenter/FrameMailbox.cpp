@@ -0,0 +1,35 @@
+// Frame mailbox. Single-slot "latest frame wins" handoff between processing and the View.
+
+#include "Presenter/FrameMailbox.h"
+#include "Model/Metrics.h"
+
+#include <QMutexLocker>
+#include <utility>
+
+
+// Put the latest frame, the undisplayed previous one is dropped.
+void FrameMailbox::post(DisplayFrame frame)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_full) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        Metrics::instance().framesDropped.add();
+    }
+    m_frame = std::move(frame);
+    m_full = true;
+    m_processed.fetch_add(1, std::memory_order_relaxed);
+    Metrics::instance().framesProcessed.add();
+}
+
+// Take the frame if there is a new one.
+bool FrameMailbox::take(DisplayFrame& frame)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_full) return false;
+    frame = std::move(m_frame);
+    m_frame = DisplayFrame();
+    m_full = false;
+    m_displayed.fetch_add(1, std::memory_order_relaxed);
+    Metrics::instance().framesDisplayed.add();
+    return true;
+}
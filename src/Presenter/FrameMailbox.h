@@ -0,0 +1,50 @@
+// Frame mailbox. Single-slot "latest frame wins" handoff between processing and the View.
+
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include <QVector>
+#include <QPointF>
+#include <QMutex>
+#include <atomic>
+
+
+// One displayable frame (already formatted for the chart).
+struct DisplayFrame
+{
+    QVector<QPointF> graph;
+    double startFreq{0.0};          // GHz
+    double stopFreq{0.0};           // GHz
+    quint64 index{0};               // Sweep sequence number.
+};
+
+
+// Holds at most one frame: posting a new frame replaces the one not yet displayed.
+// Safe to post from any thread, taken on the render tick of the main thread.
+class FrameMailbox
+{
+public:
+    FrameMailbox() = default;
+
+    // Put the latest frame, the undisplayed previous one is dropped.
+    void post(DisplayFrame frame);
+
+    // Take the frame if there is a new one.
+    bool take(DisplayFrame& frame);
+
+    // ======== Counters ========
+    quint64 processed() const { return m_processed.load(std::memory_order_relaxed); }
+    quint64 displayed() const { return m_displayed.load(std::memory_order_relaxed); }
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    QMutex m_mutex;
+    DisplayFrame m_frame;
+    bool m_full = false;
+
+    std::atomic<quint64> m_processed{0};
+    std::atomic<quint64> m_displayed{0};
+    std::atomic<quint64> m_dropped{0};
+};
+
+#endif // FRAMEMAILBOX_H
@@ -1,19 +1,62 @@
 // Presenter module. It is the link between Model and View.
 
 #include "Presenter/MeasurementPresenter.h"
+#include "Model/Metrics.h"
+
+#include <QFileInfo>
+#include <algorithm>
 
 
 MeasurementPresenter::MeasurementPresenter(IView *view, IConfigModel *config, QObject *parent)
     : QObject(parent), view(view), config(config)
 {
-    // Create a new Worker thread.
+    // Create a new Worker thread. It is started first, so the ScpiClient is set up
+    // while the rest of the application is constructed.
     m_thread = new QThread(this);
     m_worker = new VnaWorker();
     m_worker->moveToThread(m_thread);
-    m_thread->start();
-
     // Thread->Worker: Create ScpiClient inside the Worker.
     connect(m_thread, &QThread::started, m_worker, &VnaWorker::initialize);
+    m_thread->start();
+
+    // Create the limit result log thread.
+    m_limitLogThread = new QThread(this);
+    m_limitLog = new LimitLogWriter();
+    m_limitLog->moveToThread(m_limitLogThread);
+    connect(m_limitLogThread, &QThread::finished, m_limitLog, &QObject::deleteLater);
+    m_limitLogThread->start();
+
+    // Create the Touchstone export thread.
+    qRegisterMetaType<SweepPtr>("SweepPtr");
+    m_exportThread = new QThread(this);
+    m_exportWorker = new ExportWorker();
+    m_exportWorker->moveToThread(m_exportThread);
+    connect(m_exportThread, &QThread::finished, m_exportWorker, &QObject::deleteLater);
+    m_exportThread->start();
+
+    // Processing pipeline: built-in stages, default order.
+    m_pipeline = new ProcessingPipeline(this);
+    m_deembedStage = new DeembedStage();
+    m_mathStage = new MathStage();
+    m_formatStage = new FormatStage();
+    m_limitStage = new LimitStage();
+    m_pipeline->registerStage(new ParseStage());
+    m_pipeline->registerStage(m_deembedStage);
+    m_pipeline->registerStage(m_mathStage);
+    m_pipeline->registerStage(m_formatStage);
+    m_pipeline->registerStage(new WaterfallStage());
+    m_pipeline->registerStage(m_limitStage);
+    m_pipeline->configure({ "parse", "deembed", "math", "format", "waterfall", "limit" });
+    m_pipelineClock.start();
+    // Pipeline->Presenter: Processed sweeps (queued from the pool threads).
+    connect(m_pipeline, &ProcessingPipeline::frameProcessed, this, &MeasurementPresenter::onFrameProcessed);
+
+    // Create the metrics endpoint thread (listens only after setMetricsPort()).
+    m_metricsThread = new QThread(this);
+    m_metricsServer = new MetricsServer();
+    m_metricsServer->moveToThread(m_metricsThread);
+    connect(m_metricsThread, &QThread::finished, m_metricsServer, &QObject::deleteLater);
+    m_metricsThread->start();
 
     // View->Presenter: Clicking the button in the UI - "Measure".
     connect(view, &IView::measureRequested, this, &MeasurementPresenter::onHandleMeasureRequested);
@@ -33,6 +76,146 @@ MeasurementPresenter::MeasurementPresenter(IView *view, IConfigModel *config, QO
     connect(this, &MeasurementPresenter::paramsUpdated, view, &IView::onParamsUpdated);
     // Presenter->View: Passing the chart to the interface for display.
     connect(this, &MeasurementPresenter::graphUpdated, view, &IView::onSetupGraph);
+
+    // View->Presenter: Load the limit mask file.
+    connect(view, &IView::limitMaskRequested, this, &MeasurementPresenter::onLimitMaskRequested);
+    // View->Presenter: Displayed trace format selected.
+    connect(view, &IView::traceFormatChanged, this, &MeasurementPresenter::onTraceFormatChanged);
+    connect(view, &IView::groupDelayApertureChanged, this, &MeasurementPresenter::onGroupDelayApertureChanged);
+    // View->Presenter: Memory trace and trace math.
+    connect(view, &IView::memoryStoreRequested, this, &MeasurementPresenter::onMemoryStoreRequested);
+    connect(view, &IView::traceMathChanged, this, &MeasurementPresenter::onTraceMathChanged);
+    // View->Presenter: Fixture de-embedding file.
+    connect(view, &IView::fixtureRequested, this, &MeasurementPresenter::onFixtureRequested);
+    // Presenter->View: Limit test verdict.
+    connect(this, &MeasurementPresenter::limitVerdictUpdated, view, &IView::onLimitVerdict);
+    // Presenter->View: Waterfall row.
+    connect(this, &MeasurementPresenter::waterfallUpdated, view, &IView::onWaterfallUpdated);
+    // Presenter->LimitLogWriter: Asynchronous result log.
+    connect(this, &MeasurementPresenter::limitLogRequested, m_limitLog, &LimitLogWriter::open);
+    connect(this, &MeasurementPresenter::limitVerdictLogged, m_limitLog, &LimitLogWriter::appendVerdict);
+    // View->Presenter->ExportWorker: Touchstone export.
+    connect(view, &IView::touchstoneExportRequested, this, &MeasurementPresenter::onTouchstoneExportRequested);
+    connect(this, &MeasurementPresenter::exportSweepRequested, m_exportWorker, &ExportWorker::exportSweep);
+    connect(m_exportWorker, &ExportWorker::exportFinished, view, &IView::onStatusUpdated);
+    // View->Presenter->View: Trend chart range queries.
+    connect(view, &IView::trendRangeRequested, this, &MeasurementPresenter::onTrendRangeRequested);
+    // View->Presenter->Worker: Test plan runs, step data and timing back.
+    connect(view, &IView::sequenceRequested, this, &MeasurementPresenter::onSequenceRequested);
+    connect(this, &MeasurementPresenter::startSequence, m_worker, &VnaWorker::runSequence);
+    connect(m_worker, &VnaWorker::sequenceStarted, this, &MeasurementPresenter::onSequenceStarted);
+    connect(m_worker, &VnaWorker::sequenceStepMeasured, this, &MeasurementPresenter::onSequenceStepMeasured);
+    connect(m_worker, &VnaWorker::sequenceFinished, this, &MeasurementPresenter::onSequenceFinished);
+    // Presenter->View: Frame counters.
+    connect(this, &MeasurementPresenter::frameStatsUpdated, view, &IView::onFrameStats);
+    // View->Presenter->View: Sweep rate tuner.
+    connect(view, &IView::tuneRequested, this, &MeasurementPresenter::onTuneRequested);
+    connect(this, &MeasurementPresenter::tuneStatusUpdated, view, &IView::onTuneStatus);
+
+    // Render tick: the chart is repainted at most once per tick with the latest frame.
+    m_renderTimer = new QTimer(this);
+    m_renderTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_renderTimer, &QTimer::timeout, this, &MeasurementPresenter::onRenderTick);
+    setRenderRate(60);
+    m_statsTimer.start();
+}
+
+// Display refresh cap, Hz.
+void MeasurementPresenter::setRenderRate(int hz)
+{
+    hz = std::clamp(hz, 1, 240);
+    m_renderTimer->start(1000 / hz);
+}
+
+// Serve the metrics on 127.0.0.1:port, in the metrics thread.
+void MeasurementPresenter::setMetricsPort(quint16 port)
+{
+    QMetaObject::invokeMethod(m_metricsServer, [server = m_metricsServer, port]() {
+        server->start(port);
+    }, Qt::QueuedConnection);
+}
+
+// Processing stage order, used as given. Only the stages enabled by their own
+// options are added when the order leaves them out: "publish" and "record" right
+// after "parse" (they always see the raw data), "trend" at the end. Without
+// "parse" nothing is added, so a configuration error is about the given order.
+bool MeasurementPresenter::setPipelineOrder(const QStringList& order, QString* error)
+{
+    QStringList stages = order;
+    const int parse = stages.indexOf("parse");
+    if (parse >= 0) {
+        if (m_pipeline->stage("publish") && !stages.contains("publish")) stages.insert(parse + 1, "publish");
+        if (m_pipeline->stage("record") && !stages.contains("record")) stages.insert(parse + 1, "record");
+        if (m_trendStage && !stages.contains("trend")) stages.append("trend");
+    }
+    return m_pipeline->configure(stages, error);
+}
+
+// Publish every sweep to the POSIX shared memory (4 slots of up to 100001 points).
+bool MeasurementPresenter::setSharedMemoryName(const QString& name, QString* error)
+{
+    if (name.isEmpty() || m_pipeline->stage("publish")) return false;
+
+    PublishStage *stage = new PublishStage();
+    if (!stage->open(name, 4, 100001, error)) {
+        delete stage;
+        return false;
+    }
+    m_pipeline->registerStage(stage);
+    return setPipelineOrder(m_pipeline->order(), error);
+}
+
+// Record marker / band trends into dir (a new recording each run).
+bool MeasurementPresenter::setTrendRecording(const QString& dir, const QString& channels, QString* error)
+{
+    QVector<TrendChannel> parsed;
+    if (m_trendStage || dir.isEmpty() || !parseTrendChannels(channels, &parsed, error)) return false;
+
+    TrendStage *stage = new TrendStage();
+    if (!stage->open(dir, parsed, error)) {
+        delete stage;
+        return false;
+    }
+    m_pipeline->registerStage(stage);
+    m_trendStage = stage;
+    return setPipelineOrder(m_pipeline->order(), error);
+}
+
+// Record every raw sweep into a compressed file (closed with the pipeline).
+bool MeasurementPresenter::setSweepRecording(const QString& path, QString* error)
+{
+    if (path.isEmpty() || m_pipeline->stage("record")) return false;
+
+    RecordStage *stage = new RecordStage();
+    if (!stage->open(path, error)) {
+        delete stage;
+        return false;
+    }
+    m_pipeline->registerStage(stage);
+    return setPipelineOrder(m_pipeline->order(), error);
+}
+
+// Connect and show the instrument's current sweep without waiting for "Measure".
+// Read-only: the configuration is queried, not set.
+void MeasurementPresenter::connectOnStartup()
+{
+    emit startFirstMeasure();
+}
+
+// Start the multiplexing server in the Worker thread.
+void MeasurementPresenter::setMuxPort(quint16 port)
+{
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, port]() {
+        worker->setMuxPort(port);
+    }, Qt::QueuedConnection);
+}
+
+// SCPI traffic capture / replay, applied in the Worker thread.
+void MeasurementPresenter::setTransportOptions(const ScpiTransportOptions& options)
+{
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, options]() {
+        worker->setTransportOptions(options);
+    }, Qt::QueuedConnection);
 }
 
 // Destructor, close the stream.
@@ -44,6 +227,19 @@ MeasurementPresenter::~MeasurementPresenter()
         m_thread->deleteLater();
     }
     m_worker->deleteLater();
+
+    if (m_limitLogThread) {
+        m_limitLogThread->quit();
+        m_limitLogThread->wait();
+    }
+    if (m_exportThread) {
+        m_exportThread->quit();
+        m_exportThread->wait();
+    }
+    if (m_metricsThread) {
+        m_metricsThread->quit();
+        m_metricsThread->wait();
+    }
 }
 
 // "Measure" button handler.
@@ -81,68 +277,318 @@ void MeasurementPresenter::setConfig(double startFreq,
     config->setConfig(newCfg);
 }
 
-// Graph plotting method.
-// I'm save in Presenter, but VnaConfig run in the main thread.
-QVector<QPointF> MeasurementPresenter::parseSGraph(const QString& rawData)
+// Worker->View: transport parameters signal.
+void MeasurementPresenter::onConfigReceived(double startFreq,
+                                            double stopFreq,
+                                            int points,
+                                            double power,
+                                            int ifBw)
+{
+    emit paramsUpdated(startFreq / 1e9, stopFreq / 1e9, points, power / 1e9, ifBw);
+    // Save the received data to the config.
+    setConfig(startFreq / 1e9, stopFreq / 1e9, points, power, ifBw);
+}
+
+// Worker->Presenter: schedule transport signal (build and transmit).
+// The values were converted while the reply arrived; only the config snapshot
+// is taken here, the grid and everything else is done in the pipeline.
+void MeasurementPresenter::onDataReceived(const SweepPtr& sweep)
+{
+    SweepFramePtr frame(new SweepFrame);
+    frame->index = ++m_sweepIndex;
+    frame->submittedNs = m_pipelineClock.nsecsElapsed();
+    frame->config = config->getConfig();
+    frame->sweep = sweep;
+    m_pipeline->submit(frame);
+}
+
+// Pipeline->Presenter: The sweep left the last processing stage.
+void MeasurementPresenter::onFrameProcessed(const SweepFramePtr& frame)
+{
+    Metrics::instance().processNs.record(m_pipelineClock.nsecsElapsed() - frame->submittedNs);
+    if (!frame->sweep) return;
+    m_lastFrame = frame;
+    if (m_mathStage->takeMemoryDropped()) {
+        view->onStatusUpdated("Status: Memory trace cleared - grid outside the stored range");
+    }
+    if (m_deembedStage->takeOutOfRange()) {
+        view->onStatusUpdated("Status: Fixture - grid outside the file's frequencies, edge values used");
+    }
+    ++m_rateFrames;
+    addRateSample(*frame);
+
+    if (!frame->graph.isEmpty()) postFrame(frame->graph, frame->index);
+    if (!frame->waterfall.isEmpty()) emit waterfallUpdated(frame->waterfall);
+
+    // Continuous export: every Nth sweep, skipped while the previous file is still written.
+    if (m_exportEveryN > 0 && ++m_exportCounter % m_exportEveryN == 0 && !m_exportWorker->isBusy()) {
+        QFileInfo info(m_exportPath);
+        exportSweep(frame->sweep, QString("%1/%2_%3.%4")
+                        .arg(info.absolutePath(), info.completeBaseName())
+                        .arg(frame->index, 6, 10, QChar('0'))
+                        .arg(info.suffix().isEmpty() ? "s1p" : info.suffix()));
+    }
+
+    if (frame->hasVerdict) {
+        const LimitVerdict& verdict = frame->verdict;
+        emit limitVerdictUpdated(verdict.passed, verdict.worstMarginDb,
+                                 verdict.worstFreqHz / 1e6, verdict.failedPoints);
+        emit limitVerdictLogged(frame->index, verdict.passed, verdict.worstMarginDb,
+                                verdict.worstFreqHz, verdict.failedPoints);
+    }
+}
+
+// View->Presenter: Change the displayed trace format and redraw the last sweep.
+void MeasurementPresenter::onTraceFormatChanged(int format)
+{
+    if (format < 0 || format >= int(TraceFormat::Count)) return;
+    m_displayFormat = TraceFormat(format);
+    m_formatStage->setFormat(m_displayFormat);
+
+    // The last frame is out of the pipeline, its memo is only used here.
+    if (m_lastFrame) postFrame(m_lastFrame->formats.points(m_displayFormat), m_lastFrame->index);
+}
+
+// View->Presenter: Change the group delay aperture and redraw a displayed group delay.
+void MeasurementPresenter::onGroupDelayApertureChanged(int points)
+{
+    m_formatStage->setGroupDelayAperture(points);
+    if (!m_lastFrame || m_displayFormat != TraceFormat::GroupDelay) return;
+    m_lastFrame->formats.setGroupDelayAperture(points);
+    postFrame(m_lastFrame->formats.points(m_displayFormat), m_lastFrame->index);
+}
+
+// Post the chart points to the mailbox (replaces an undisplayed frame).
+void MeasurementPresenter::postFrame(const QVector<QPointF>& graph, quint64 index)
 {
-    //Get current configuration.
     VnaConfig cfg = config->getConfig();
+    DisplayFrame frame;
+    frame.graph = graph;
+    frame.startFreq = cfg.startFreq;
+    frame.stopFreq = cfg.stopFreq;
+    frame.index = index;
+    m_mailbox.post(std::move(frame));
+}
 
-    QVector<QPointF> result;
+// Render tick: display the latest frame, publish counters once per second.
+void MeasurementPresenter::onRenderTick()
+{
+    DisplayFrame frame;
+    if (m_mailbox.take(frame)) {
+        // Graph data, startFreq and stopFreq to update the X axis.
+        emit graphUpdated(frame.graph, frame.startFreq, frame.stopFreq);
+    }
 
-    // Split raw comma-separated string into individual numeric tokens.
-    // Example input: 0.1, -0.2 ,0.3...
-    QStringList parts = rawData.split(',', Qt::SkipEmptyParts);
+    if (m_statsTimer.elapsed() >= 1000) {
+        const double achievedHz = m_rateFrames * 1000.0 / m_statsTimer.restart();
+        m_rateFrames = 0;
+        emit frameStatsUpdated(m_mailbox.processed(), m_mailbox.displayed(), m_mailbox.dropped());
 
-    // Use configured number of points; fall back to 101 if invalid.
-    int numPoints = cfg.points > 0 ? cfg.points : 101;
-    if (numPoints <= 1) numPoints = 2;
+        const VnaConfig cfg = config->getConfig();
+        const double predictedHz = m_rateModel.sampleCount() > 0
+                                       ? m_rateModel.predictedRateHz(cfg.points, cfg.ifBw)
+                                       : 0.0;
+        emit tuneStatusUpdated(predictedHz, achievedHz);
 
-    // Convert start/stop frequencies from GHz (as stored) to Hz for internal calculations.
-    double startHz = cfg.startFreq * 1e9;
-    double stopHz = cfg.stopFreq * 1e9;
+        // Auto mode: retune once the applied configuration has a few samples.
+        if (m_tuneAuto && m_tuneSamples >= 5) {
+            m_tuneSamples = 0;
+            tune(true);
+        }
+    }
+}
 
-    // Parse real/imaginary pairs and convert to magnitude (dB) vs frequency (MHz).
-    for (int i = 0; i < numPoints && i * 2 + 1 < parts.size(); ++i) {
-        bool ok1, ok2;
-        double re = parts[2 * i].toDouble(&ok1);            // Real part.
-        double im = parts[2 * i + 1].toDouble(&ok2);        // Imaginary part.
+// Add the sweep's timing to the rate model. Sweeps that do not match the
+// configuration snapshot (a change still in flight) are skipped.
+void MeasurementPresenter::addRateSample(const SweepFrame& frame)
+{
+    const SweepData& sweep = *frame.sweep;
+    if (sweep.acquireNs <= 0 || sweep.size() != frame.config.points) return;
 
-        if (!ok1 || !ok2) continue;
+    // Mean chart update time since the previous sample (renders run on the tick).
+    const LatencyHistogram& render = Metrics::instance().renderNs;
+    const quint64 count = render.count();
+    const quint64 sumNs = render.sumNs();
+    if (count > m_renderCount) m_renderMs = (sumNs - m_renderSumNs) / 1e6 / (count - m_renderCount);
+    m_renderCount = count;
+    m_renderSumNs = sumNs;
 
-        // Compute magnitude: |S| = sqrt(Re^2 + Im^2).
-        double mag = std::sqrt(re * re + im * im);
+    SweepTiming sample;
+    sample.points = frame.config.points;
+    sample.ifBw = frame.config.ifBw;
+    sample.acquireMs = sweep.acquireNs / 1e6;
+    sample.transferMs = sweep.transferNs / 1e6;
+    sample.parseMs = sweep.parseNs / 1e6;
+    sample.renderMs = m_renderMs;
+    m_rateModel.addSample(sample);
+    ++m_tuneSamples;
+}
 
-        // Convert to decibels: 20 * log10(|S|).
-        // Clamp to 1e-12 to avoid log(0) → -inf.
-        double magDb = 20.0 * std::log10(std::max(mag, 1e-12));
+// View->Presenter: Sweep rate tuner target (the Points field is the minimum resolution).
+void MeasurementPresenter::onTuneRequested(double targetHz, int minPoints, bool autoApply)
+{
+    m_tuneTargetHz = targetHz;
+    m_tuneMinPoints = minPoints;
+    m_tuneAuto = autoApply;
+    tune(autoApply);
+}
+
+// Suggest the narrowest IF bandwidth that reaches the target at the minimum points.
+// Applying goes through the normal "Measure" path, as if typed into the fields.
+void MeasurementPresenter::tune(bool apply)
+{
+    const VnaConfig cfg = config->getConfig();
+    const RateSuggestion suggestion = m_rateModel.suggest(m_tuneTargetHz, m_tuneMinPoints);
+    if (!suggestion.valid) {
+        view->onStatusUpdated("Status: Tuner - no sweep timing yet");
+        return;
+    }
 
-        // Linearly interpolate frequency across the sweep range.
-        double freqHz = startHz + (stopHz - startHz) * i / (numPoints - 1);
+    const SweepTiming& t = suggestion.timing;
+    view->onStatusUpdated(QString("Status: Tuner - %1 pts, IFBW %2 Hz: %3 Hz%4 "
+                                  "(sweep %5 + transfer %6 ms, parse %7, render %8 ms)")
+                              .arg(suggestion.points).arg(suggestion.ifBw)
+                              .arg(suggestion.predictedHz, 0, 'f', 1)
+                              .arg(suggestion.meetsTarget ? "" : " - target not reachable")
+                              .arg(t.acquireMs, 0, 'f', 1).arg(t.transferMs, 0, 'f', 1)
+                              .arg(t.parseMs, 0, 'f', 1).arg(t.renderMs, 0, 'f', 1));
+
+    if (!apply || (cfg.points == suggestion.points && cfg.ifBw == suggestion.ifBw)) return;
+    m_tuneSamples = 0;
+    emit paramsUpdated(cfg.startFreq, cfg.stopFreq, suggestion.points, cfg.power, suggestion.ifBw);
+    onHandleMeasureRequested(cfg.startFreq, cfg.stopFreq, suggestion.points, cfg.power, suggestion.ifBw);
+}
+
+// View->Presenter: Touchstone export of the current / every Nth sweep.
+void MeasurementPresenter::onTouchstoneExportRequested(const QString& path,
+                                                        int format,
+                                                        int version,
+                                                        int everyN)
+{
+    m_exportPath = path;
+    m_exportFormat = format;
+    m_exportVersion = version;
+    m_exportEveryN = everyN;
+    m_exportCounter = 0;
 
-        // Store as (frequency in MHz, magnitude in dB) — standard units for RF plots.
-        result.append(QPointF(freqHz / 1e6, magDb));
+    if (everyN > 0) {
+        view->onStatusUpdated(QString("Status: Exporting every %1 sweep(s)").arg(everyN));
+    } else if (m_lastFrame) {
+        exportSweep(m_lastFrame->sweep, path);
+    } else {
+        view->onStatusUpdated("Status: No sweep to export");
     }
-    return result;
 }
 
-// Worker->View: transport parameters signal.
-void MeasurementPresenter::onConfigReceived(double startFreq,
-                                            double stopFreq,
-                                            int points,
-                                            double power,
-                                            int ifBw)
+// Queue the sweep for export. Its grid was fixed up by applySweepGrid() in the
+// "parse" stage, so the frequencies match the values even on a short reply.
+void MeasurementPresenter::exportSweep(const SweepPtr& sweep, const QString& path)
 {
-    emit paramsUpdated(startFreq / 1e9, stopFreq / 1e9, points, power / 1e9, ifBw);
-    // Save the received data to the config.
-    setConfig(startFreq / 1e9, stopFreq / 1e9, points, power, ifBw);
+    m_exportWorker->markBusy();
+    emit exportSweepRequested(sweep, path, m_exportFormat, m_exportVersion);
 }
 
-// Worker->Presenter: schedule transport signal (build and transmit).
-void MeasurementPresenter::onDataReceived(const QString& rawData)
+// View->Presenter: The last data sweep (before math) becomes the memory trace.
+void MeasurementPresenter::onMemoryStoreRequested()
 {
-    QVector<QPointF> data = parseSGraph(rawData);
-    VnaConfig cfg = config->getConfig();
-    // Graph data, startFreq and stopFreq to update the X axis.
-    emit graphUpdated(data, cfg.startFreq, cfg.stopFreq);
+    view->onStatusUpdated(m_mathStage->storeMemory() ? "Status: Data stored to memory"
+                                                     : "Status: No sweep to store");
+}
+
+// View->Presenter: Trace math operation and hold mode (a new hold starts over).
+void MeasurementPresenter::onTraceMathChanged(int op, int hold)
+{
+    if (op < 0 || op >= int(TraceMathOp::Count) || hold < 0 || hold >= int(TraceHold::Count)) return;
+    m_mathStage->setOperation(TraceMathOp(op), TraceHold(hold));
+    if ((TraceMathOp(op) != TraceMathOp::Data || TraceHold(hold) != TraceHold::Off)
+        && !m_pipeline->order().contains("math")) {
+        view->onStatusUpdated("Status: Trace math - no \"math\" stage in the pipeline order");
+    }
+}
+
+// View->Presenter: Load a 2-port fixture file; an empty path turns de-embedding off.
+void MeasurementPresenter::onFixtureRequested(const QString& path)
+{
+    if (path.isEmpty()) {
+        m_deembedStage->clear();
+        view->onStatusUpdated("Status: Fixture off");
+        return;
+    }
+
+    QString error;
+    FixtureDeembedding fixture;
+    if (!fixture.load(path, &error)) {
+        view->onStatusUpdated(QString("Status: Fixture error - %1").arg(error));
+        return;
+    }
+    m_deembedStage->setFixture(fixture);
+    view->onStatusUpdated(m_pipeline->order().contains("deembed")
+                              ? QString("Status: Fixture loaded - %1").arg(fixture.name())
+                              : QString("Status: Fixture loaded - %1, but no \"deembed\" stage in the pipeline order")
+                                    .arg(fixture.name()));
+}
+
+// View->Presenter: Trend chart range. Reads at most `buckets` records (plus a
+// binary search), whatever the zoom level.
+void MeasurementPresenter::onTrendRangeRequested(qint64 fromMs, qint64 toMs, int buckets)
+{
+    if (!m_trendStage) return;
+    view->onTrendUpdated(m_trendStage->store().query(fromMs, toMs, buckets));
+}
+
+// View->Presenter: Run a test plan for the next DUT.
+void MeasurementPresenter::onSequenceRequested(const QString& planPath)
+{
+    emit startSequence(planPath);
+}
+
+// Worker->Presenter: The run began. A request the worker refused (already running,
+// not connected, bad plan) never gets here, so it uses up no DUT number.
+void MeasurementPresenter::onSequenceStarted(const QString& planPath)
+{
+    m_sequencePlan = planPath;
+    ++m_sequenceDut;
+}
+
+// Worker->Presenter: Store a test plan step as <plan>_dut<N>_<step>.s1p.
+// Files are queued on the export thread, never skipped; the grid is the step's own.
+void MeasurementPresenter::onSequenceStepMeasured(int step, const QString& name, const SweepPtr& sweep)
+{
+    Q_UNUSED(step);
+    QFileInfo info(m_sequencePlan);
+    const QString path = QString("%1/%2_dut%3_%4.s1p")
+                             .arg(info.absolutePath(), info.completeBaseName())
+                             .arg(m_sequenceDut, 3, 10, QChar('0'))
+                             .arg(name);
+
+    m_exportWorker->markBusy();
+    emit exportSweepRequested(sweep, path, m_exportFormat, m_exportVersion);
+}
+
+// Worker->Presenter: Per-DUT time against the time the instrument spent sweeping.
+void MeasurementPresenter::onSequenceFinished(int steps, qint64 totalNs, qint64 sweepNs)
+{
+    view->onStatusUpdated(QString("Status: DUT %1 done - %2 step(s) in %3 ms (sweeps %4 ms)")
+                              .arg(m_sequenceDut)
+                              .arg(steps)
+                              .arg(totalNs / 1000000.0, 0, 'f', 1)
+                              .arg(sweepNs / 1000000.0, 0, 'f', 1));
+}
+
+// View->Presenter: Load a limit mask file and open the result log next to it.
+// A file that fails to load leaves the current mask in use.
+void MeasurementPresenter::onLimitMaskRequested(const QString& path)
+{
+    QString error;
+    LimitMask mask;
+    if (!mask.loadFromFile(path, &error)) {
+        // The mask in use (if any) stays active, as with a failed fixture load.
+        view->onStatusUpdated(QString("Status: Limit mask error - %1").arg(error));
+        return;
+    }
+    m_limitStage->setMask(mask);
+
+    QFileInfo info(path);
+    emit limitLogRequested(info.absolutePath() + "/" + info.completeBaseName() + "_results.csv");
+    view->onStatusUpdated(QString("Status: Limit mask loaded - %1").arg(info.fileName()));
 }
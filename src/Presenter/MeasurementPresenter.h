@@ -7,11 +7,23 @@
 #include "Interfaces/IVnaView.h"
 #include "Interfaces/IVnaConfig.h"
 #include "Workers/VnaWorker.h"
+#include "Workers/LimitLogWriter.h"
+#include "Workers/ExportWorker.h"
+#include "Workers/MetricsServer.h"
+#include "Model/LimitMask.h"
+#include "Model/SweepData.h"
+#include "Model/SweepRateModel.h"
+#include "Model/TraceFormats.h"
+#include "Presenter/FrameMailbox.h"
+#include "Presenter/ProcessingPipeline.h"
+#include "Presenter/ProcessingStages.h"
 
 #include <QObject>
 #include <QVector>
 #include <QPointF>
 #include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
 #include <cmath>
 
 
@@ -26,6 +38,34 @@ public:
                                   QObject *parent = nullptr);
     virtual ~MeasurementPresenter();
 
+    // Display refresh cap, Hz (acquisition and processing are not throttled).
+    void setRenderRate(int hz);
+
+    // SCPI traffic capture / replay instead of the instrument socket.
+    void setTransportOptions(const ScpiTransportOptions& options);
+
+    // Serve the metrics in Prometheus text format on 127.0.0.1:port (0 = off).
+    void setMetricsPort(quint16 port);
+
+    // Share the instrument connection with local clients on 127.0.0.1:port (0 = off).
+    void setMuxPort(quint16 port);
+
+    // Connect and show the current sweep without waiting for "Measure"
+    // (queued after the transport options).
+    void connectOnStartup();
+
+    // Processing stage order, e.g. "parse,deembed,math,format,waterfall,limit" (used as given).
+    bool setPipelineOrder(const QStringList& order, QString* error = nullptr);
+
+    // Publish every sweep to the POSIX shared memory "/name" (call before setPipelineOrder).
+    bool setSharedMemoryName(const QString& name, QString* error = nullptr);
+
+    // Record marker / band trends ("1.5,2.0-2.5" GHz) into dir (call before setPipelineOrder).
+    bool setTrendRecording(const QString& dir, const QString& channels, QString* error = nullptr);
+
+    // Record every raw sweep into a compressed file (call before setPipelineOrder).
+    bool setSweepRecording(const QString& path, QString* error = nullptr);
+
 signals:
     // Signal from the "Measure" button.
     void startFirstMeasure();
@@ -49,6 +89,39 @@ signals:
                         double startFreq,
                         double stopFreq);
 
+    // Presenter->View: Frame counters (processed / displayed / dropped).
+    void frameStatsUpdated(quint64 processed,
+                            quint64 displayed,
+                            quint64 dropped);
+
+    // Presenter->View: New waterfall row (log magnitude, dB).
+    void waterfallUpdated(const QVector<double>& magDb);
+
+    // Presenter->View: Limit test verdict of the last sweep.
+    void limitVerdictUpdated(bool passed,
+                                double worstMarginDb,
+                                double worstFreqMhz,
+                                int failedPoints);
+
+    // Presenter->LimitLogWriter: Append the verdict to the result log.
+    void limitVerdictLogged(quint64 sweepIndex,
+                            bool passed,
+                            double worstMarginDb,
+                            double worstFreqHz,
+                            int failedPoints);
+
+    // Presenter->ExportWorker: Write the sweep to a Touchstone file.
+    void exportSweepRequested(const SweepPtr& sweep,
+                                const QString& path,
+                                int format,
+                                int version);
+
+    // Presenter->LimitLogWriter: Open the result log.
+    void limitLogRequested(const QString& path);
+
+    // Presenter->Worker: Run the test plan once (one DUT).
+    void startSequence(const QString& planPath);
+
 private slots:
     // "Measure" button handler.
     void onHandleMeasureRequested(double startFreq,
@@ -72,16 +145,124 @@ private slots:
                             int ifBw);
 
     // Worker->Presenter: schedule transport signal (build and transmit).
-    void onDataReceived(const QString& rawData);
+    void onDataReceived(const SweepPtr& sweep);
+
+    // Pipeline->Presenter: The sweep left the last processing stage.
+    void onFrameProcessed(const SweepFramePtr& frame);
+
+    // View->Presenter: Load a limit mask file.
+    void onLimitMaskRequested(const QString& path);
+
+    // View->Presenter: Touchstone export of the current / every Nth sweep.
+    void onTouchstoneExportRequested(const QString& path,
+                                        int format,
+                                        int version,
+                                        int everyN);
+
+    // View->Presenter: Displayed trace format selected.
+    void onTraceFormatChanged(int format);
+
+    // View->Presenter: Group delay aperture, steps.
+    void onGroupDelayApertureChanged(int points);
+
+    // View->Presenter: Store the current data sweep as the memory trace.
+    void onMemoryStoreRequested();
+
+    // View->Presenter: Trace math operation and hold mode.
+    void onTraceMathChanged(int op, int hold);
+
+    // View->Presenter: Load (or turn off) the fixture de-embedding.
+    void onFixtureRequested(const QString& path);
+
+    // View->Presenter: Trend chart range.
+    void onTrendRangeRequested(qint64 fromMs, qint64 toMs, int buckets);
+
+    // View->Presenter: Run a test plan for the next DUT.
+    void onSequenceRequested(const QString& planPath);
+
+    // Worker->Presenter: The test plan run began, number its DUT.
+    void onSequenceStarted(const QString& planPath);
+
+    // Worker->Presenter: Store a test plan step.
+    void onSequenceStepMeasured(int step, const QString& name, const SweepPtr& sweep);
+
+    // Worker->Presenter: Per-DUT timing of the test plan.
+    void onSequenceFinished(int steps, qint64 totalNs, qint64 sweepNs);
+
+    // View->Presenter: Suggest (or apply) points / IF bandwidth for a refresh rate.
+    void onTuneRequested(double targetHz, int minPoints, bool autoApply);
+
+    // Render tick: display the latest frame from the mailbox.
+    void onRenderTick();
 
 private:
-    // Method for plotting a graph.
-    QVector<QPointF> parseSGraph(const QString& rawData);
+    // Post the chart points of a sweep to the mailbox.
+    void postFrame(const QVector<QPointF>& graph, quint64 index);
+
+    // Queue the sweep for export (on its own grid).
+    void exportSweep(const SweepPtr& sweep, const QString& path);
+
+    // Add the sweep's timing to the rate model.
+    void addRateSample(const SweepFrame& frame);
+
+    // Suggest points / IF bandwidth for the tuner target, apply it in auto mode.
+    void tune(bool apply);
 
     IView *view;
     IConfigModel *config;
     VnaWorker *m_worker = nullptr;
     QThread *m_thread;
+
+    // Asynchronous limit result log.
+    LimitLogWriter *m_limitLog = nullptr;
+    QThread *m_limitLogThread = nullptr;
+    quint64 m_sweepIndex = 0;
+
+    // Processing stages on the thread pool, the last processed sweep (with its
+    // memoized formats) and the displayed format.
+    ProcessingPipeline *m_pipeline = nullptr;
+    DeembedStage *m_deembedStage = nullptr;
+    MathStage *m_mathStage = nullptr;
+    FormatStage *m_formatStage = nullptr;
+    LimitStage *m_limitStage = nullptr;
+    TrendStage *m_trendStage = nullptr;
+    SweepFramePtr m_lastFrame;
+    QElapsedTimer m_pipelineClock;
+    TraceFormat m_displayFormat = TraceFormat::LogMag;
+
+    // Touchstone export thread and continuous export settings.
+    ExportWorker *m_exportWorker = nullptr;
+    QThread *m_exportThread = nullptr;
+    QString m_exportPath;
+    int m_exportFormat = 0;
+    int m_exportVersion = 1;
+    int m_exportEveryN = 0;
+    quint64 m_exportCounter = 0;
+
+    // Test plan: step files are stored next to the plan, numbered per DUT.
+    QString m_sequencePlan;
+    int m_sequenceDut = 0;
+
+    // Sweep rate tuner: timing model, render time since the last sample,
+    // sweeps in the current stats second and the target.
+    SweepRateModel m_rateModel;
+    quint64 m_renderCount = 0;
+    quint64 m_renderSumNs = 0;
+    double m_renderMs = 0.0;
+    int m_rateFrames = 0;
+    double m_tuneTargetHz = 0.0;
+    int m_tuneMinPoints = 0;
+    bool m_tuneAuto = false;
+    int m_tuneSamples = 0;              // Samples since the last applied suggestion.
+
+    // Prometheus metrics endpoint thread.
+    MetricsServer *m_metricsServer = nullptr;
+    QThread *m_metricsThread = nullptr;
+
+    // Latest-wins handoff to the View and the render rate cap.
+    FrameMailbox m_mailbox;
+    QTimer *m_renderTimer = nullptr;
+    QElapsedTimer m_statsTimer;
 };
 
 #endif // MEASUREMENTPRESENTER_H
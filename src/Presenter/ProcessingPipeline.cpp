@@ -0,0 +1,159 @@
+// Processing pipeline. Ordered, pluggable trace-processing stages run on a thread pool.
+
+#include "Presenter/ProcessingPipeline.h"
+
+#include <QMutexLocker>
+#include <QSet>
+
+
+ProcessingPipeline::ProcessingPipeline(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<SweepFramePtr>("SweepFramePtr");
+}
+
+// Wait for the frames in flight before the stages are destroyed.
+ProcessingPipeline::~ProcessingPipeline()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        for (Lane& lane : m_lanes) lane.queue.clear();
+    }
+    m_pool.waitForDone();
+}
+
+// Make a stage available for configuration.
+void ProcessingPipeline::registerStage(ProcessingStage *stage)
+{
+    QMutexLocker locker(&m_mutex);
+    m_registry.emplace_back(stage);
+}
+
+ProcessingStage* ProcessingPipeline::stage(const QString& name) const
+{
+    QMutexLocker locker(&m_mutex);
+    for (const auto& s : m_registry) {
+        if (s->name() == name) return s.get();
+    }
+    return nullptr;
+}
+
+QStringList ProcessingPipeline::availableStages() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList names;
+    for (const auto& s : m_registry) names << s->name();
+    return names;
+}
+
+// Set the stage order and check the declared inputs / outputs.
+bool ProcessingPipeline::configure(const QStringList& order, QString* error)
+{
+    QVector<Lane> lanes;
+    QSet<QString> available = { "raw", "config" };
+
+    for (const QString& name : order) {
+        ProcessingStage *s = stage(name.trimmed());
+        if (!s) {
+            if (error) *error = QString("Unknown processing stage '%1'").arg(name);
+            return false;
+        }
+        for (const QString& input : s->inputs()) {
+            if (!available.contains(input)) {
+                if (error) *error = QString("Stage '%1' needs '%2', which no earlier stage produces")
+                                        .arg(s->name(), input);
+                return false;
+            }
+        }
+        for (const QString& output : s->outputs()) available.insert(output);
+
+        Lane lane;
+        lane.stage = s;
+        lane.timing = &Metrics::instance().stageNs(s->name());
+        lanes.append(lane);
+    }
+
+    // Drain the old configuration before switching.
+    {
+        QMutexLocker locker(&m_mutex);
+        for (Lane& lane : m_lanes) lane.queue.clear();
+    }
+    m_pool.waitForDone();
+
+    QMutexLocker locker(&m_mutex);
+    m_lanes = lanes;
+    m_pool.setMaxThreadCount(std::max(int(m_lanes.size()), 2));
+    return true;
+}
+
+QStringList ProcessingPipeline::order() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList names;
+    for (const Lane& lane : m_lanes) names << lane.stage->name();
+    return names;
+}
+
+// Feed a new sweep.
+void ProcessingPipeline::submit(const SweepFramePtr& frame)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_lanes.isEmpty()) {
+        locker.unlock();
+        emit frameProcessed(frame);
+        return;
+    }
+
+    // The first stage is behind: drop the oldest waiting sweep, never block acquisition.
+    QQueue<SweepFramePtr>& queue = m_lanes[0].queue;
+    while (queue.size() >= m_maxQueued) {
+        queue.dequeue();
+        Metrics::instance().pipelineDropped.add();
+    }
+    enqueueLocked(0, frame);
+}
+
+// Put the frame into the lane and start the lane if it is idle.
+void ProcessingPipeline::enqueueLocked(int lane, const SweepFramePtr& frame)
+{
+    Lane& l = m_lanes[lane];
+    l.queue.enqueue(frame);
+    if (!l.busy) {
+        l.busy = true;
+        m_pool.start([this, lane]() { runLane(lane); });
+    }
+}
+
+// Process the lane queue until it is empty.
+void ProcessingPipeline::runLane(int lane)
+{
+    for (;;) {
+        SweepFramePtr frame;
+        ProcessingStage *stage = nullptr;
+        LatencyHistogram *timing = nullptr;
+        {
+            QMutexLocker locker(&m_mutex);
+            Lane& l = m_lanes[lane];
+            if (l.queue.isEmpty()) {
+                l.busy = false;
+                return;
+            }
+            frame = l.queue.dequeue();
+            stage = l.stage;
+            timing = l.timing;
+        }
+
+        {
+            ScopedLatency latency(*timing);
+            stage->process(*frame);
+        }
+
+        QMutexLocker locker(&m_mutex);
+        if (lane + 1 < m_lanes.size()) {
+            enqueueLocked(lane + 1, frame);
+        } else {
+            locker.unlock();
+            emit frameProcessed(frame);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+// Processing pipeline. Ordered, pluggable trace-processing stages run on a thread pool.
+
+#ifndef PROCESSINGPIPELINE_H
+#define PROCESSINGPIPELINE_H
+
+#include "Interfaces/IVnaConfig.h"
+#include "Model/SweepData.h"
+#include "Model/TraceFormats.h"
+#include "Model/LimitMask.h"
+#include "Model/Metrics.h"
+
+#include <QObject>
+#include <QMutex>
+#include <QQueue>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QSharedPointer>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+
+// Everything known about one sweep while it flows through the stages.
+// Field names in quotes are the names stages use to declare inputs / outputs.
+struct SweepFrame
+{
+    quint64 index{0};
+    qint64 submittedNs{0};
+    VnaConfig config;                   // "config" - grid snapshot at arrival
+    QString rawData;                    // "raw"
+    SweepPtr sweep;                     // "sweep"
+    TraceFormatter formats;             // Per-sweep memo of the derived formats.
+    QVector<QPointF> graph;             // "graph"     - displayed format
+    QVector<double> waterfall;          // "waterfall" - log magnitude row
+    bool hasVerdict{false};             // "verdict"
+    LimitVerdict verdict;
+};
+
+using SweepFramePtr = QSharedPointer<SweepFrame>;
+
+Q_DECLARE_METATYPE(SweepFramePtr)
+
+
+// One processing step. A stage never sees two sweeps at the same time,
+// so its own state needs no locking against itself.
+class ProcessingStage
+{
+public:
+    virtual ~ProcessingStage() = default;
+
+    virtual QString name() const = 0;
+    virtual QStringList inputs() const = 0;
+    virtual QStringList outputs() const = 0;
+
+    virtual void process(SweepFrame& frame) = 0;
+};
+
+
+// Each configured stage is a lane with its own queue, run by at most one pool
+// thread at a time. Sweep n+1 enters stage k while sweep n is in stage k+1, so the
+// throughput is bound by the slowest stage rather than the sum of all of them.
+class ProcessingPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProcessingPipeline(QObject *parent = nullptr);
+    ~ProcessingPipeline() override;
+
+    // Make a stage available for configuration (takes ownership).
+    void registerStage(ProcessingStage *stage);
+    ProcessingStage* stage(const QString& name) const;
+    QStringList availableStages() const;
+
+    // Set the stage order. Each input must be produced by an earlier stage
+    // (or be "raw" / "config"). Waits for the frames in flight.
+    bool configure(const QStringList& order, QString* error = nullptr);
+    QStringList order() const;
+
+    // Frames waiting for the first stage; the oldest is dropped above it.
+    void setMaxQueued(int frames) { m_maxQueued = std::max(frames, 1); }
+
+    // Feed a new sweep (any thread).
+    void submit(const SweepFramePtr& frame);
+
+signals:
+    // The frame left the last stage (emitted from a pool thread, in sweep order).
+    void frameProcessed(const SweepFramePtr& frame);
+
+private:
+    struct Lane
+    {
+        ProcessingStage *stage = nullptr;
+        LatencyHistogram *timing = nullptr;
+        QQueue<SweepFramePtr> queue;
+        bool busy = false;
+    };
+
+    // Put the frame into the lane and start the lane if it is idle (m_mutex held).
+    void enqueueLocked(int lane, const SweepFramePtr& frame);
+    // Process the lane queue until it is empty.
+    void runLane(int lane);
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<ProcessingStage>> m_registry;
+    QVector<Lane> m_lanes;
+    QThreadPool m_pool;
+    int m_maxQueued = 4;
+};
+
+#endif // PROCESSINGPIPELINE_H
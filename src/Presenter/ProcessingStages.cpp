@@ -0,0 +1,162 @@
+// Built-in processing stages of the pipeline.
+
+#include "Presenter/ProcessingStages.h"
+#include "Model/SweepParser.h"
+
+#include <QMutexLocker>
+#include <QDateTime>
+
+
+// "parse": raw ASCII reply -> complex sweep. A sweep converted while it was
+// streamed in only gets its grid here.
+void ParseStage::process(SweepFrame& frame)
+{
+    if (frame.sweep) {
+        frame.sweep = applySweepGrid(frame.sweep, frame.config, frame.index);
+    } else {
+        frame.sweep = parseSGraph(frame.rawData, frame.config, frame.index);
+    }
+    frame.formats.setSweep(frame.sweep);
+    frame.rawData.clear();          // Not needed any more.
+}
+
+// Replace the fixture.
+void DeembedStage::setFixture(const FixtureDeembedding& fixture)
+{
+    QMutexLocker locker(&m_mutex);
+    m_fixture = fixture;
+    m_warned = false;
+}
+
+void DeembedStage::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_fixture.clear();
+}
+
+// "deembed": without a fixture the sweep passes through untouched; the fixture
+// terms are interpolated only on grid change.
+void DeembedStage::process(SweepFrame& frame)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_fixture.isEmpty() || !frame.sweep) return;
+
+    bool outOfRange = false;
+    frame.sweep = m_fixture.apply(frame.sweep, &outOfRange);
+    frame.formats.setSweep(frame.sweep);
+    if (outOfRange && !m_warned) {
+        m_warned = true;
+        m_outOfRange.store(true);
+    }
+}
+
+// Math settings. Selecting a hold restarts it.
+void MathStage::setOperation(TraceMathOp op, TraceHold hold)
+{
+    QMutexLocker locker(&m_mutex);
+    m_math.setOperation(op);
+    m_math.setHold(hold);
+}
+
+// Store the last data sweep as the memory trace.
+bool MathStage::storeMemory()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_lastData) return false;
+    m_math.storeMemory(m_lastData);
+    return true;
+}
+
+// "math": with nothing enabled the sweep passes through untouched.
+void MathStage::process(SweepFrame& frame)
+{
+    QMutexLocker locker(&m_mutex);
+    m_lastData = frame.sweep;
+    if (!m_math.isActive()) return;
+
+    bool dropped = false;
+    frame.sweep = m_math.apply(frame.sweep, &dropped);
+    frame.formats.setSweep(frame.sweep);
+    if (dropped) m_memoryDropped.store(true);
+}
+
+// "format": only the displayed format (and what it depends on) is computed.
+void FormatStage::process(SweepFrame& frame)
+{
+    frame.formats.setGroupDelayAperture(m_aperture.load(std::memory_order_relaxed));
+    frame.graph = frame.formats.points(TraceFormat(m_format.load(std::memory_order_relaxed)));
+}
+
+// "waterfall": log magnitude, shared with the limit test through the memo.
+void WaterfallStage::process(SweepFrame& frame)
+{
+    frame.waterfall = frame.formats.values(TraceFormat::LogMag);
+}
+
+// Replace the mask.
+void LimitStage::setMask(const LimitMask& mask)
+{
+    QMutexLocker locker(&m_mutex);
+    m_mask = mask;
+}
+
+// "limit": mask resampled only on grid change, then one pass over the points.
+void LimitStage::process(SweepFrame& frame)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_mask.isEmpty() || !frame.sweep) return;
+
+    const VnaConfig& cfg = frame.config;
+    double startHz = cfg.startFreq * 1e9;
+    double stopHz = cfg.stopFreq * 1e9;
+    int points = cfg.points > 1 ? cfg.points : frame.sweep->size();
+    if (!m_mask.matchesGrid(startHz, stopHz, points)) {
+        m_mask.resample(startHz, stopHz, points);
+    }
+
+    frame.verdict = m_mask.check(frame.formats.values(TraceFormat::LogMag));
+    frame.hasVerdict = true;
+}
+
+// Create the region.
+bool PublishStage::open(const QString& name, int slots, int maxPoints, QString* error)
+{
+    return m_publisher.open(name, slots, maxPoints, error);
+}
+
+// "publish": one copy into the next ring slot, readers are never waited for.
+void PublishStage::process(SweepFrame& frame)
+{
+    if (frame.sweep) m_publisher.publish(*frame.sweep, frame.config);
+}
+
+// Start the recording.
+bool TrendStage::open(const QString& dir, const QVector<TrendChannel>& channels, QString* error)
+{
+    m_lo.resize(channels.size());
+    m_hi.resize(channels.size());
+    return m_store.open(dir, channels, error);
+}
+
+// "trend": log magnitude at each marker (nearest point) or min / max over each band.
+// Channels outside the grid are stored as NaN.
+void TrendStage::process(SweepFrame& frame)
+{
+    if (!frame.sweep || frame.sweep->size() == 0) return;
+
+    trendChannelValues(*frame.sweep, frame.formats.values(TraceFormat::LogMag), m_store.channels(),
+                       m_lo.data(), m_hi.data());
+    m_store.append(QDateTime::currentMSecsSinceEpoch(), m_lo.constData(), m_hi.constData());
+}
+
+// Create the recording file.
+bool RecordStage::open(const QString& path, QString* error)
+{
+    return m_writer.open(path, error);
+}
+
+// "record": the sweep is XOR-encoded against the previous one of its block.
+void RecordStage::process(SweepFrame& frame)
+{
+    if (frame.sweep) m_writer.append(*frame.sweep, QDateTime::currentMSecsSinceEpoch());
+}
@@ -0,0 +1,173 @@
+// Built-in processing stages of the pipeline.
+
+#ifndef PROCESSINGSTAGES_H
+#define PROCESSINGSTAGES_H
+
+#include "Presenter/ProcessingPipeline.h"
+#include "Model/LimitMask.h"
+#include "Model/TraceFormats.h"
+#include "Model/TraceMath.h"
+#include "Model/FixtureDeembedding.h"
+#include "Model/SweepShmPublisher.h"
+#include "Model/TrendStore.h"
+#include "Model/SweepRecording.h"
+
+#include <QMutex>
+#include <atomic>
+
+
+// "parse": raw ASCII reply -> complex sweep.
+class ParseStage : public ProcessingStage
+{
+public:
+    QString name() const override { return "parse"; }
+    QStringList inputs() const override { return { "raw", "config" }; }
+    QStringList outputs() const override { return { "sweep" }; }
+    void process(SweepFrame& frame) override;
+};
+
+// "deembed": removes the loaded fixture from the sweep (replaces the sweep).
+class DeembedStage : public ProcessingStage
+{
+public:
+    QString name() const override { return "deembed"; }
+    QStringList inputs() const override { return { "sweep" }; }
+    QStringList outputs() const override { return { "sweep" }; }
+    void process(SweepFrame& frame) override;
+
+    // Settings (main thread). setFixture takes a loaded fixture, clear() turns it off.
+    void setFixture(const FixtureDeembedding& fixture);
+    void clear();
+    // True once after a sweep grid reached outside the fixture frequencies.
+    bool takeOutOfRange() { return m_outOfRange.exchange(false); }
+
+private:
+    QMutex m_mutex;             // Only contended when the fixture changes.
+    FixtureDeembedding m_fixture;
+    bool m_warned = false;      // Out of range reported for this fixture.
+    std::atomic<bool> m_outOfRange{false};
+};
+
+// "math": data <-> memory operations and per-point hold (replaces the sweep).
+class MathStage : public ProcessingStage
+{
+public:
+    QString name() const override { return "math"; }
+    QStringList inputs() const override { return { "sweep" }; }
+    QStringList outputs() const override { return { "sweep" }; }
+    void process(SweepFrame& frame) override;
+
+    // Settings (main thread).
+    void setOperation(TraceMathOp op, TraceHold hold);
+    // Store the last data sweep (before math) as the memory trace. False without data.
+    bool storeMemory();
+    // True once after the memory trace was dropped on a grid change.
+    bool takeMemoryDropped() { return m_memoryDropped.exchange(false); }
+
+private:
+    QMutex m_mutex;             // Only contended when the settings change.
+    TraceMath m_math;
+    SweepPtr m_lastData;
+    std::atomic<bool> m_memoryDropped{false};
+};
+
+// "format": displayed trace format -> chart points.
+class FormatStage : public ProcessingStage
+{
+public:
+    QString name() const override { return "format"; }
+    QStringList inputs() const override { return { "sweep" }; }
+    QStringList outputs() const override { return { "graph" }; }
+    void process(SweepFrame& frame) override;
+
+    // Displayed format (set from the main thread).
+    void setFormat(TraceFormat format) { m_format.store(int(format), std::memory_order_relaxed); }
+    // Group delay aperture, steps (set from the main thread).
+    void setGroupDelayAperture(int steps) { m_aperture.store(steps, std::memory_order_relaxed); }
+
+private:
+    std::atomic<int> m_format{int(TraceFormat::LogMag)};
+    std::atomic<int> m_aperture{1};
+};
+
+// "waterfall": log magnitude row for the waterfall view.
+class WaterfallStage : public ProcessingStage
+{
+public:
+    QString name() const override { return "waterfall"; }
+    QStringList inputs() const override { return { "sweep" }; }
+    QStringList outputs() const override { return { "waterfall" }; }
+    void process(SweepFrame& frame) override;
+};
+
+// "limit": pass/fail against the limit mask.
+class LimitStage : public ProcessingStage
+{
+public:
+    QString name() const override { return "limit"; }
+    QStringList inputs() const override { return { "sweep", "config" }; }
+    QStringList outputs() const override { return { "verdict" }; }
+    void process(SweepFrame& frame) override;
+
+    // Replace the mask (main thread). An empty mask disables the test.
+    void setMask(const LimitMask& mask);
+
+private:
+    QMutex m_mutex;             // Only contended when a new mask is loaded.
+    LimitMask m_mask;
+};
+
+// "publish": sweep -> shared-memory ring for local processes (no outputs).
+class PublishStage : public ProcessingStage
+{
+public:
+    QString name() const override { return "publish"; }
+    QStringList inputs() const override { return { "sweep", "config" }; }
+    QStringList outputs() const override { return {}; }
+    void process(SweepFrame& frame) override;
+
+    // Create the region (main thread, before the stage is configured).
+    bool open(const QString& name, int slots, int maxPoints, QString* error = nullptr);
+
+private:
+    SweepShmPublisher m_publisher;
+};
+
+// "trend": marker / band values of every sweep -> trend store (no outputs).
+class TrendStage : public ProcessingStage
+{
+public:
+    QString name() const override { return "trend"; }
+    QStringList inputs() const override { return { "sweep" }; }
+    QStringList outputs() const override { return {}; }
+    void process(SweepFrame& frame) override;
+
+    // Start the recording (main thread, before the stage is configured).
+    bool open(const QString& dir, const QVector<TrendChannel>& channels, QString* error = nullptr);
+
+    // Thread-safe, queried by the presenter for the trend chart.
+    TrendStore& store() { return m_store; }
+
+private:
+    TrendStore m_store;
+    QVector<float> m_lo;
+    QVector<float> m_hi;
+};
+
+// "record": raw complex sweep -> compressed recording file (no outputs).
+class RecordStage : public ProcessingStage
+{
+public:
+    QString name() const override { return "record"; }
+    QStringList inputs() const override { return { "sweep" }; }
+    QStringList outputs() const override { return {}; }
+    void process(SweepFrame& frame) override;
+
+    // Create the file (main thread, before the stage is configured).
+    bool open(const QString& path, QString* error = nullptr);
+
+private:
+    SweepRecordWriter m_writer;
+};
+
+#endif // PROCESSINGSTAGES_H
@@ -0,0 +1,50 @@
+// Stats panel. Small live view of the pipeline metrics.
+// Reads the lock-free counters only, nothing is pushed from the hot path.
+
+#include "View/StatsPanel.h"
+#include "Model/Metrics.h"
+
+#include <algorithm>
+
+
+StatsPanel::StatsPanel(QWidget *parent)
+    : QLabel(parent)
+{
+    setStyleSheet("QLabel { font: 9pt \"Consolas\"; color: rgb(180, 180, 180); }");
+    setTextFormat(Qt::PlainText);
+
+    m_timer = new QTimer(this);
+    connect(m_timer, &QTimer::timeout, this, &StatsPanel::refresh);
+    m_timer->start(1000);
+    m_clock.start();
+    refresh();
+}
+
+// Refresh the rates and latencies.
+void StatsPanel::refresh()
+{
+    const Metrics& m = Metrics::instance();
+    const double seconds = std::max(m_clock.restart(), qint64(1)) / 1000.0;
+
+    const quint64 sweeps = m.sweepsReceived.value();
+    const quint64 bytes = m.bytesRead.value();
+    const double sweepRate = (sweeps - m_lastSweeps) / seconds;
+    const double byteRate = (bytes - m_lastBytes) / seconds;
+    m_lastSweeps = sweeps;
+    m_lastBytes = bytes;
+
+    auto ms = [](const LatencyHistogram& h, double q) { return h.quantile(q) / 1e6; };
+
+    setText(QString("Sweeps/s   %1\n"
+                    "Socket     %2 kB/s\n"
+                    "Parse      p50 %3 / p99 %4 ms\n"
+                    "Render     p50 %5 / p99 %6 ms\n"
+                    "Dropped    %7\n"
+                    "Reconnects %8")
+                .arg(sweepRate, 0, 'f', 1)
+                .arg(byteRate / 1024.0, 0, 'f', 1)
+                .arg(ms(m.parseNs, 0.5), 0, 'f', 2).arg(ms(m.parseNs, 0.99), 0, 'f', 2)
+                .arg(ms(m.renderNs, 0.5), 0, 'f', 2).arg(ms(m.renderNs, 0.99), 0, 'f', 2)
+                .arg(m.framesDropped.value())
+                .arg(m.reconnects.value()));
+}
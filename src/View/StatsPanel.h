@@ -0,0 +1,32 @@
+// Stats panel. Small live view of the pipeline metrics.
+
+#ifndef STATSPANEL_H
+#define STATSPANEL_H
+
+#include <QLabel>
+#include <QTimer>
+#include <QElapsedTimer>
+
+
+class StatsPanel : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit StatsPanel(QWidget *parent = nullptr);
+    ~StatsPanel() override = default;
+
+private slots:
+    // Refresh the rates and latencies (once per second).
+    void refresh();
+
+private:
+    QTimer *m_timer = nullptr;
+    QElapsedTimer m_clock;
+
+    // Previous counter values for the rates.
+    quint64 m_lastSweeps = 0;
+    quint64 m_lastBytes = 0;
+};
+
+#endif // STATSPANEL_H
@@ -0,0 +1,174 @@
+// Trend view. Marker / band values over time.
+// Every redraw asks for about one bucket per two pixels, so the amount of data read
+// from the trend store does not depend on the zoom level.
+
+#include "View/TrendWidget.h"
+
+#include <QPainter>
+#include <QDateTime>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QVector>
+#include <QLineF>
+#include <QPointF>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+
+namespace {
+constexpr qint64 kMinSpanMs = 1000;
+constexpr qint64 kMaxSpanMs = 7LL * 24 * 3600 * 1000;
+
+const QColor kChannelColors[] = { QColor(255, 215, 0), QColor(0, 200, 255), QColor(255, 90, 90),
+                                  QColor(120, 230, 120), QColor(220, 130, 255) };
+}
+
+
+TrendWidget::TrendWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumHeight(100);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    m_followTimer = new QTimer(this);
+    connect(m_followTimer, &QTimer::timeout, this, &TrendWidget::onFollowTick);
+    m_followTimer->start(1000);
+}
+
+// Show the buckets returned for the last requested range.
+void TrendWidget::setSeries(const TrendSeries& series)
+{
+    m_series = series;
+    update();
+}
+
+// Follow mode: keep the right edge at the current time.
+void TrendWidget::onFollowTick()
+{
+    if (m_follow) requestRange();
+}
+
+void TrendWidget::requestRange()
+{
+    if (m_follow) m_toMs = QDateTime::currentMSecsSinceEpoch();
+    emit rangeRequested(m_toMs - m_spanMs, m_toMs, std::max(width() / 2, 1));
+}
+
+void TrendWidget::resizeEvent(QResizeEvent *)
+{
+    requestRange();
+}
+
+// Wheel: zoom around the time under the cursor (follow mode keeps the right edge).
+void TrendWidget::wheelEvent(QWheelEvent *event)
+{
+    const double factor = event->angleDelta().y() > 0 ? 0.8 : 1.25;
+    const qint64 span = std::clamp(qint64(m_spanMs * factor), kMinSpanMs, kMaxSpanMs);
+
+    if (!m_follow) {
+        const double x = event->position().x() / std::max(width(), 1);
+        const qint64 anchor = m_toMs - m_spanMs + qint64(m_spanMs * x);
+        m_toMs = anchor + qint64(span * (1.0 - x));
+    }
+    m_spanMs = span;
+    requestRange();
+}
+
+// Drag: pan (leaves follow mode).
+void TrendWidget::mousePressEvent(QMouseEvent *event)
+{
+    m_dragStart = event->pos();
+    m_dragToMs = m_follow ? QDateTime::currentMSecsSinceEpoch() : m_toMs;
+}
+
+void TrendWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!(event->buttons() & Qt::LeftButton)) return;
+    const int dx = event->pos().x() - m_dragStart.x();
+    m_follow = false;
+    m_toMs = m_dragToMs - qint64(double(dx) / std::max(width(), 1) * m_spanMs);
+    requestRange();
+}
+
+// Double click: back to follow mode over the whole recording.
+void TrendWidget::mouseDoubleClickEvent(QMouseEvent *)
+{
+    m_follow = true;
+    if (m_series.lastMs > m_series.firstMs) {
+        m_spanMs = std::clamp(QDateTime::currentMSecsSinceEpoch() - m_series.firstMs, kMinSpanMs, kMaxSpanMs);
+    }
+    requestRange();
+}
+
+// One min/max bar per bucket, joined by a line through the bucket midpoints.
+void TrendWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(30, 30, 30));
+    painter.setPen(QColor(150, 150, 150));
+
+    const int channels = m_series.channels.size();
+    const int n = m_series.size();
+    if (channels == 0) {
+        painter.drawText(rect(), Qt::AlignCenter, "Trend: off");
+        return;
+    }
+
+    // Autoscale over the finite values in view.
+    float minY = std::numeric_limits<float>::infinity();
+    float maxY = -minY;
+    for (int i = 0; i < n * channels; ++i) {
+        if (std::isfinite(m_series.lo[i])) minY = std::min(minY, m_series.lo[i]);
+        if (std::isfinite(m_series.hi[i])) maxY = std::max(maxY, m_series.hi[i]);
+    }
+    if (!(minY <= maxY)) {
+        minY = -1.0f;
+        maxY = 1.0f;
+    }
+    const float margin = std::max((maxY - minY) * 0.05f, 0.5f);
+    minY -= margin;
+    maxY += margin;
+
+    const qint64 fromMs = m_toMs - m_spanMs;
+    const double sx = double(width()) / m_spanMs;
+    const double sy = height() / double(maxY - minY);
+    auto mapX = [&](qint64 t) { return (t - fromMs) * sx; };
+    auto mapY = [&](float v) { return (maxY - v) * sy; };
+
+    QVector<QLineF> bars;
+    QVector<QPointF> line;
+    bars.reserve(n);
+    line.reserve(n);
+    for (int c = 0; c < channels; ++c) {
+        bars.clear();
+        line.clear();
+        for (int i = 0; i < n; ++i) {
+            const float lo = m_series.lo[i * channels + c];
+            const float hi = m_series.hi[i * channels + c];
+            if (!std::isfinite(lo) || !std::isfinite(hi)) continue;
+
+            const double x = mapX((m_series.startMs[i] + m_series.stopMs[i]) / 2);
+            if (hi > lo) bars.append(QLineF(x, mapY(lo), x, mapY(hi)));
+            line.append(QPointF(x, mapY((lo + hi) * 0.5f)));
+        }
+
+        const QColor color = kChannelColors[c % int(std::size(kChannelColors))];
+        painter.setPen(color.darker(150));
+        painter.drawLines(bars);
+        painter.setPen(color);
+        painter.drawPolyline(line.constData(), line.size());
+        painter.drawText(6 + 110 * c, 14, m_series.channels[c].name);
+    }
+
+    // Scale and resolution of the buckets in view.
+    painter.setPen(QColor(150, 150, 150));
+    painter.drawText(rect().adjusted(6, 0, -6, -4), Qt::AlignBottom | Qt::AlignLeft,
+                     QString("%1 .. %2 dB").arg(minY + margin, 0, 'f', 1).arg(maxY - margin, 0, 'f', 1));
+    painter.drawText(rect().adjusted(6, 0, -6, -4), Qt::AlignBottom | Qt::AlignRight,
+                     QString("%1 s, %2 sweep(s) per point%3")
+                         .arg(m_spanMs / 1000.0, 0, 'f', 0)
+                         .arg(qint64(std::pow(double(TrendStore::kFanout), m_series.level)))
+                         .arg(m_follow ? ", live" : ""));
+}
@@ -0,0 +1,54 @@
+// Trend view. Marker / band values over time, zoomable from the whole recording
+// down to single sweeps.
+
+#ifndef TRENDWIDGET_H
+#define TRENDWIDGET_H
+
+#include "Model/TrendStore.h"
+
+#include <QWidget>
+#include <QTimer>
+#include <QPoint>
+
+
+class TrendWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TrendWidget(QWidget *parent = nullptr);
+    ~TrendWidget() override = default;
+
+    // Show the buckets returned for the last requested range.
+    void setSeries(const TrendSeries& series);
+
+signals:
+    // Time range to show and the number of buckets that fit the width.
+    void rangeRequested(qint64 fromMs, qint64 toMs, int buckets);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private slots:
+    // Follow mode: keep the right edge at the current time.
+    void onFollowTick();
+
+private:
+    void requestRange();
+
+    TrendSeries m_series;
+    QTimer *m_followTimer = nullptr;
+    bool m_follow = true;
+    qint64 m_spanMs = 10 * 60 * 1000;
+    qint64 m_toMs = 0;
+
+    QPoint m_dragStart;
+    qint64 m_dragToMs = 0;
+};
+
+#endif // TRENDWIDGET_H
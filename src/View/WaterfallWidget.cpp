@@ -0,0 +1,180 @@
+// Waterfall view. Frequency x time display of the sweep history, colored by magnitude.
+// The display image has the widget's size and is itself a ring of pixel lines: a new
+// sweep colors only its own line(s) and moves the top line, and painting is two
+// unscaled blits around it. The whole history is re-rendered only when the size,
+// depth, range or point count changes.
+
+#include "View/WaterfallWidget.h"
+
+#include <QPainter>
+#include <QColor>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+
+WaterfallWidget::WaterfallWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    // Palette: black -> blue -> cyan -> yellow -> red.
+    const QColor stops[] = { QColor(0, 0, 0), QColor(0, 0, 200), QColor(0, 200, 220),
+                             QColor(240, 230, 40), QColor(230, 30, 30) };
+    const int segments = int(std::size(stops)) - 1;
+    m_palette.resize(256);
+    for (int i = 0; i < 256; ++i) {
+        double pos = i / 255.0 * segments;
+        int s = std::min(int(pos), segments - 1);
+        double t = pos - s;
+        const QColor& a = stops[s];
+        const QColor& b = stops[s + 1];
+        m_palette[i] = qRgb(int(a.red() + (b.red() - a.red()) * t),
+                            int(a.green() + (b.green() - a.green()) * t),
+                            int(a.blue() + (b.blue() - a.blue()) * t));
+    }
+
+    setMinimumHeight(120);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    m_history.reset(200, 0);
+}
+
+// Number of sweeps kept in the history.
+void WaterfallWidget::setHistoryDepth(int rows)
+{
+    rows = std::max(rows, 1);
+    if (rows == m_history.capacity()) return;
+    m_history.reset(rows, m_history.columns());
+    rebuildDisplay();
+}
+
+// Color scale range, dB.
+void WaterfallWidget::setRange(double minDb, double maxDb)
+{
+    if (maxDb <= minDb) return;
+    m_minDb = minDb;
+    m_maxDb = maxDb;
+    rebuildDisplay();
+}
+
+// Append one sweep: store it in the ring and color its display line(s).
+void WaterfallWidget::appendSweep(const QVector<double>& magDb)
+{
+    const bool resized = magDb.size() != m_history.columns();
+    m_history.append(magDb.constData(), magDb.size());
+
+    if (resized || m_display.isNull()) {
+        rebuildDisplay();
+    } else {
+        addToDisplay(m_history.row(0));
+        update();
+    }
+}
+
+void WaterfallWidget::resizeEvent(QResizeEvent *)
+{
+    rebuildDisplay();
+}
+
+// Display geometry: with more sweeps than pixel lines, several sweeps share a line
+// (max hold, so short peaks stay visible); with fewer, each sweep gets whole lines.
+// Lines below the history depth stay black. Columns are reduced by max as well.
+void WaterfallWidget::layoutDisplay()
+{
+    const qreal dpr = devicePixelRatioF();
+    const int w = int(width() * dpr);
+    const int h = int(height() * dpr);
+    const int columns = m_history.columns();
+    const int rows = m_history.capacity();
+    m_lineSweeps = 0;
+    m_top = 0;
+    if (w <= 0 || h <= 0 || columns <= 0 || rows <= 0) {
+        m_display = QImage();
+        return;
+    }
+
+    m_sweepsPerLine = (rows + h - 1) / h;
+    m_linesPerSweep = std::max(h / rows, 1);
+    m_visibleLines = std::min(h, m_sweepsPerLine > 1 ? (rows + m_sweepsPerLine - 1) / m_sweepsPerLine
+                                                     : rows * m_linesPerSweep);
+
+    if (m_display.width() != w || m_display.height() != h) {
+        m_display = QImage(w, h, QImage::Format_RGB32);
+        m_display.setDevicePixelRatio(dpr);
+    }
+    m_display.fill(Qt::black);
+
+    m_columnStart.resize(w + 1);
+    for (int x = 0; x <= w; ++x) m_columnStart[x] = int(qint64(x) * columns / w);
+    m_lineMax.resize(w);
+}
+
+// Merge one sweep into the top line, or start a new top line (scrolling the ring).
+void WaterfallWidget::addToDisplay(const float *values)
+{
+    if (m_display.isNull() || !values) return;
+
+    const int w = m_display.width();
+    const int h = m_display.height();
+    const bool newLine = m_lineSweeps == 0 || m_lineSweeps == m_sweepsPerLine;
+    if (newLine) {
+        std::fill(m_lineMax.begin(), m_lineMax.end(), std::numeric_limits<float>::lowest());
+        m_lineSweeps = 0;
+    }
+
+    float *lineMax = m_lineMax.data();
+    const int *start = m_columnStart.constData();
+    for (int x = 0; x < w; ++x) {
+        const int end = std::max(start[x + 1], start[x] + 1);
+        float v = values[start[x]];
+        for (int c = start[x] + 1; c < end; ++c) v = std::max(v, values[c]);
+        lineMax[x] = std::max(lineMax[x], v);
+    }
+    ++m_lineSweeps;
+
+    if (newLine) {
+        for (int l = 0; l < m_linesPerSweep; ++l) {
+            m_top = (m_top + h - 1) % h;
+            if (m_visibleLines < h) {
+                // The line that just left the history depth.
+                const int gone = (m_top + m_visibleLines) % h;
+                std::fill_n(reinterpret_cast<QRgb *>(m_display.scanLine(gone)), w, qRgb(0, 0, 0));
+            }
+        }
+    }
+
+    const float minDb = float(m_minDb);
+    const float scale = float(255.0 / (m_maxDb - m_minDb));
+    QRgb *first = reinterpret_cast<QRgb *>(m_display.scanLine(m_top));
+    for (int x = 0; x < w; ++x) {
+        const float v = std::min(std::max((lineMax[x] - minDb) * scale, 0.0f), 255.0f);
+        first[x] = m_palette[int(v)];
+    }
+    for (int l = 1; l < m_linesPerSweep; ++l) {
+        std::copy_n(first, w, reinterpret_cast<QRgb *>(m_display.scanLine((m_top + l) % h)));
+    }
+}
+
+// Full re-render of the history, oldest first.
+void WaterfallWidget::rebuildDisplay()
+{
+    layoutDisplay();
+    for (int age = m_history.count() - 1; age >= 0; --age) addToDisplay(m_history.row(age));
+    update();
+}
+
+// Newest sweep at the top: display lines [top, end) then [0, top), unscaled.
+void WaterfallWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    if (m_display.isNull()) {
+        painter.fillRect(rect(), Qt::black);
+        return;
+    }
+
+    const int w = m_display.width();
+    const int h = m_display.height();
+    const qreal dpr = m_display.devicePixelRatio();
+    painter.drawImage(QPointF(0, 0), m_display, QRectF(0, m_top, w, h - m_top));
+    if (m_top > 0) {
+        painter.drawImage(QPointF(0, (h - m_top) / dpr), m_display, QRectF(0, 0, w, m_top));
+    }
+}
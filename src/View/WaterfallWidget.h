@@ -0,0 +1,59 @@
+// Waterfall view. Frequency x time display of the sweep history, colored by magnitude.
+
+#ifndef WATERFALLWIDGET_H
+#define WATERFALLWIDGET_H
+
+#include "Model/SweepHistory.h"
+
+#include <QWidget>
+#include <QImage>
+#include <QVector>
+
+
+class WaterfallWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit WaterfallWidget(QWidget *parent = nullptr);
+    ~WaterfallWidget() override = default;
+
+    // Number of sweeps kept in the history (bounded memory).
+    void setHistoryDepth(int rows);
+    int historyDepth() const { return m_history.capacity(); }
+
+    // Color scale range, dB.
+    void setRange(double minDb, double maxDb);
+
+    // Append one sweep (magnitude, dB): only its display line(s) are colored.
+    void appendSweep(const QVector<double>& magDb);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    // Size the display for the widget and the history depth, black.
+    void layoutDisplay();
+    // Color one sweep into the display, scrolling it when a new line starts.
+    void addToDisplay(const float *values);
+    // Full re-render, only after size / depth / range / point count changes.
+    void rebuildDisplay();
+
+    SweepHistory m_history;
+    QVector<QRgb> m_palette;
+    double m_minDb = -80.0;
+    double m_maxDb = 10.0;
+
+    // Widget-sized ring of pixel lines, newest at m_top.
+    QImage m_display;
+    int m_top = 0;
+    int m_sweepsPerLine = 1;        // > 1 when the depth exceeds the height.
+    int m_linesPerSweep = 1;        // > 1 when the height exceeds the depth.
+    int m_visibleLines = 0;         // Lines covered by the history depth.
+    int m_lineSweeps = 0;           // Sweeps merged into the top line so far.
+    QVector<int> m_columnStart;     // First history column of each pixel column (+ end).
+    QVector<float> m_lineMax;       // Top line before coloring, dB.
+};
+
+#endif // WATERFALLWIDGET_H
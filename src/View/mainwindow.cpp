@@ -1,6 +1,76 @@
 // View module. Displays the client UI and intercepts user actions.
 
 #include "View/mainwindow.h"
+#include "View/WaterfallWidget.h"
+#include "View/TrendWidget.h"
+#include "Model/Metrics.h"
+
+#include <QFileDialog>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+
+// Reflection coefficient of the normalized impedance r + jx.
+QPointF gammaOf(double r, double x)
+{
+    const std::complex<double> z(r, x);
+    const std::complex<double> g = (z - 1.0) / (z + 1.0);
+    return QPointF(g.real(), g.imag());
+}
+
+// Smith chart grid: constant resistance circles, constant reactance arcs, real axis.
+QVector<QVector<QPointF>> smithGridLines()
+{
+    static const double values[] = { 0.2, 0.5, 1.0, 2.0, 5.0 };
+    const int steps = 180;
+    QVector<QVector<QPointF>> lines;
+
+    // r = const: x over (-inf, inf), closed at Gamma = 1.
+    for (double r : { 0.0, 0.2, 0.5, 1.0, 2.0, 5.0 }) {
+        QVector<QPointF> line{ QPointF(1.0, 0.0) };
+        for (int i = 1; i < steps; ++i) line.append(gammaOf(r, std::tan(kPi * (double(i) / steps - 0.5))));
+        line.append(QPointF(1.0, 0.0));
+        lines.append(line);
+    }
+    // x = +-const: r over [0, inf).
+    for (double x : values) {
+        for (double sign : { 1.0, -1.0 }) {
+            QVector<QPointF> line;
+            for (int i = 0; i < steps; ++i) line.append(gammaOf(std::tan(kPi / 2 * i / steps), sign * x));
+            line.append(QPointF(1.0, 0.0));
+            lines.append(line);
+        }
+    }
+    lines.append(QVector<QPointF>{ QPointF(-1.0, 0.0), QPointF(1.0, 0.0) });
+    return lines;
+}
+
+// Polar grid: |S| rings every 0.2 and phase spokes every 30 deg.
+QVector<QVector<QPointF>> polarGridLines()
+{
+    const int steps = 180;
+    QVector<QVector<QPointF>> lines;
+    for (int k = 1; k <= 5; ++k) {
+        const double radius = 0.2 * k;
+        QVector<QPointF> ring;
+        for (int i = 0; i <= steps; ++i) {
+            const double a = 2.0 * kPi * i / steps;
+            ring.append(QPointF(radius * std::cos(a), radius * std::sin(a)));
+        }
+        lines.append(ring);
+    }
+    for (int deg = 0; deg < 180; deg += 30) {
+        const double a = deg * kPi / 180.0;
+        lines.append(QVector<QPointF>{ QPointF(-std::cos(a), -std::sin(a)), QPointF(std::cos(a), std::sin(a)) });
+    }
+    return lines;
+}
+}
 
 
 MainWindow::MainWindow(QWidget *parent)
@@ -9,11 +79,53 @@ MainWindow::MainWindow(QWidget *parent)
     ui->setupUi(this);
     setWindowTitle("MyTeskTask");
 
-    // Styling the QChart chart.
-    setupChart();
+    // The chart (QChart, axes, QChartView) is built after the first paint, see event().
 
     // "Measure" button handle.
     connect(ui->measure_pushButton, &QPushButton::clicked, this, &MainWindow::onMeasureButtonClicked);
+    // "Limit mask" button handle.
+    connect(ui->limits_pushButton, &QPushButton::clicked, this, &MainWindow::onLimitsButtonClicked);
+
+    // "Plan" button handle.
+    connect(ui->sequence_pushButton, &QPushButton::clicked, this, &MainWindow::onSequenceButtonClicked);
+    connect(ui->fixture_pushButton, &QPushButton::clicked, this, &MainWindow::onFixtureButtonClicked);
+
+    // "Export" button handle.
+    connect(ui->export_pushButton, &QPushButton::clicked, this, &MainWindow::onExportButtonClicked);
+
+    // "Tune" button and "Auto" check box handle.
+    connect(ui->tune_pushButton, &QPushButton::clicked, this, &MainWindow::onTuneButtonClicked);
+    connect(ui->tuneAuto_checkBox, &QCheckBox::toggled, this, &MainWindow::onTuneButtonClicked);
+
+    // Trace format selector (order matches TraceFormat).
+    for (int i = 0; i < int(TraceFormat::Count); ++i) {
+        ui->format_comboBox->addItem(traceFormatName(TraceFormat(i)));
+    }
+    connect(ui->format_comboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onFormatChanged);
+    connect(ui->aperture_spinBox, qOverload<int>(&QSpinBox::valueChanged),
+            this, &MainWindow::groupDelayApertureChanged);
+
+    // Trace math and hold selectors (order matches TraceMathOp / TraceHold), memory store.
+    for (int i = 0; i < int(TraceMathOp::Count); ++i) {
+        ui->math_comboBox->addItem(traceMathName(TraceMathOp(i)));
+    }
+    for (int i = 0; i < int(TraceHold::Count); ++i) {
+        ui->hold_comboBox->addItem(traceHoldName(TraceHold(i)));
+    }
+    connect(ui->math_comboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onTraceMathChanged);
+    connect(ui->hold_comboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onTraceMathChanged);
+    connect(ui->memory_pushButton, &QPushButton::clicked, this, &MainWindow::memoryStoreRequested);
+
+    // Trend chart: the widget asks for its range, the Presenter queries the store.
+    connect(ui->trend_widget, &TrendWidget::rangeRequested, this, &MainWindow::trendRangeRequested);
+
+    // Waterfall history depth (memory = depth * points * 5 bytes).
+    ui->waterfall_widget->setHistoryDepth(ui->history_spinBox->value());
+    connect(ui->history_spinBox, qOverload<int>(&QSpinBox::valueChanged),
+            ui->waterfall_widget, &WaterfallWidget::setHistoryDepth);
 }
 
 MainWindow::~MainWindow()
@@ -21,6 +133,19 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
+// The controls are painted before the chart exists: the first UpdateRequest of the
+// window queues the chart construction behind it.
+bool MainWindow::event(QEvent *event)
+{
+    const bool result = IView::event(event);
+    if (event->type() == QEvent::UpdateRequest && !m_chartQueued) {
+        m_chartQueued = true;
+        Metrics::instance().markStartup("first_paint");
+        QMetaObject::invokeMethod(this, &MainWindow::setupChart, Qt::QueuedConnection);
+    }
+    return result;
+}
+
 // Click on the "Measure" button.
 void MainWindow::onMeasureButtonClicked()
 {
@@ -34,6 +159,86 @@ void MainWindow::onMeasureButtonClicked()
     emit measureRequested(startFreq, stopFreq, points, power, ifBw);
 }
 
+// Click on the "Limit mask" button.
+void MainWindow::onLimitsButtonClicked()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Limit mask", QString(),
+                                                "Limit mask (*.lim *.txt);;All files (*)");
+    if (!path.isEmpty()) emit limitMaskRequested(path);
+}
+
+// Click on the "Plan" button.
+void MainWindow::onSequenceButtonClicked()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Test plan", QString(),
+                                                "Test plan (*.plan *.txt);;All files (*)");
+    if (!path.isEmpty()) emit sequenceRequested(path);
+}
+
+// Click on the "Fixture" button. Cancel turns the de-embedding off.
+void MainWindow::onFixtureButtonClicked()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Fixture", QString(),
+                                                "Touchstone 2-port (*.s2p);;All files (*)");
+    emit fixtureRequested(path);
+}
+
+// Click on the "Export" button.
+void MainWindow::onExportButtonClicked()
+{
+    QString path = QFileDialog::getSaveFileName(this, "Touchstone export", "sweep.s1p",
+                                                "Touchstone (*.s1p);;All files (*)");
+    if (path.isEmpty()) return;
+
+    emit touchstoneExportRequested(path,
+                                   ui->exportFormat_comboBox->currentIndex(),
+                                   ui->exportVersion_comboBox->currentIndex() + 1,
+                                   ui->exportEvery_spinBox->value());
+}
+
+// Click on the "Tune" button (or "Auto" toggled): the Points field is the minimum resolution.
+void MainWindow::onTuneButtonClicked()
+{
+    emit tuneRequested(ui->tuneRate_doubleSpinBox->value(),
+                       ui->points_spinBox->value(),
+                       ui->tuneAuto_checkBox->isChecked());
+}
+
+// Trace format selected: reset the axes and ask the Presenter to redraw.
+void MainWindow::onFormatChanged(int index)
+{
+    m_format = TraceFormat(index);
+    applyFormatAxes();
+    emit traceFormatChanged(index);
+}
+
+// Axis ranges and labels of the displayed format.
+void MainWindow::applyFormatAxes()
+{
+    if (!m_axisX || !m_axisY) return;
+
+    if (isComplexPlaneFormat(m_format)) {
+        m_axisX->setRange(-1.0, 1.0);
+        m_axisY->setRange(-1.0, 1.0);
+        m_axisX->setLabelFormat("%.1f");
+    } else {
+        m_axisX->setLabelFormat("%.0f");
+        if (m_format == TraceFormat::LogMag) m_axisY->setRange(-50, 50);
+    }
+
+    // The plane grids replace the rectangular one.
+    for (QLineSeries *line : m_smithGrid) line->setVisible(m_format == TraceFormat::Smith);
+    for (QLineSeries *line : m_polarGrid) line->setVisible(m_format == TraceFormat::Polar);
+    m_axisX->setGridLineVisible(!isComplexPlaneFormat(m_format));
+    m_axisY->setGridLineVisible(!isComplexPlaneFormat(m_format));
+}
+
+// Trace math or hold selected.
+void MainWindow::onTraceMathChanged()
+{
+    emit traceMathChanged(ui->math_comboBox->currentIndex(), ui->hold_comboBox->currentIndex());
+}
+
 // Changing the connection status.
 void MainWindow::onStatusUpdated(const QString& msg)
 {
@@ -60,11 +265,78 @@ void MainWindow::onSetupGraph(const QVector<QPointF>& data,
                               double startFreq,
                               double stopFreq)
 {
-    if (m_series) m_series->replace(data);
+    // Before the chart exists only the latest trace is kept.
+    if (!m_series) {
+        m_pendingGraph = data;
+        m_pendingStartFreq = startFreq;
+        m_pendingStopFreq = stopFreq;
+        return;
+    }
+
+    ScopedLatency latency(Metrics::instance().renderNs);
+    m_series->replace(data);
+    if (!m_traceShown && !data.isEmpty()) {
+        m_traceShown = true;
+        Metrics::instance().markStartup("first_trace");
+    }
+
+    // Complex plane formats keep the fixed unit circle range.
+    if (isComplexPlaneFormat(m_format)) return;
+
     updateXAxisRange(startFreq, stopFreq);
+    if (m_format != TraceFormat::LogMag) updateYAxisRange(data);
+}
+
+// Update the frame counters.
+void MainWindow::onFrameStats(quint64 processed,
+                                quint64 displayed,
+                                quint64 dropped)
+{
+    ui->frames_label->setText(QString("Frames: %1 processed / %2 shown / %3 dropped")
+                                  .arg(processed).arg(displayed).arg(dropped));
+}
+
+// Predicted / achieved refresh rate.
+void MainWindow::onTuneStatus(double predictedHz,
+                                double achievedHz)
+{
+    ui->tune_label->setText(predictedHz > 0.0
+                                ? QString("Rate: %1 Hz predicted / %2 Hz achieved")
+                                      .arg(predictedHz, 0, 'f', 1).arg(achievedHz, 0, 'f', 1)
+                                : QString("Rate: %1 Hz achieved").arg(achievedHz, 0, 'f', 1));
+}
+
+// Append a new row to the waterfall.
+void MainWindow::onWaterfallUpdated(const QVector<double>& magDb)
+{
+    ui->waterfall_widget->appendSweep(magDb);
 }
 
-// Styling the graph chart.
+// Show the trend buckets of the requested range.
+void MainWindow::onTrendUpdated(const TrendSeries& series)
+{
+    ui->trend_widget->setSeries(series);
+}
+
+// Show the limit test verdict of the last sweep.
+void MainWindow::onLimitVerdict(bool passed,
+                                double worstMarginDb,
+                                double worstFreqMhz,
+                                int failedPoints)
+{
+    if (passed) {
+        ui->limit_label->setText(QString("PASS  %1 dB").arg(worstMarginDb, 0, 'f', 2));
+        ui->limit_label->setStyleSheet("QLabel { font: 700 10pt \"Yu Gothic UI\"; color: rgb(90, 200, 90); }");
+    } else {
+        ui->limit_label->setText(QString("FAIL  %1 dB @ %2 MHz (%3 pts)")
+                                     .arg(worstMarginDb, 0, 'f', 2)
+                                     .arg(worstFreqMhz, 0, 'f', 3)
+                                     .arg(failedPoints));
+        ui->limit_label->setStyleSheet("QLabel { font: 700 10pt \"Yu Gothic UI\"; color: rgb(230, 70, 70); }");
+    }
+}
+
+// Styling the graph chart (once, after the first paint).
 void MainWindow::setupChart()
 {
     // Series.
@@ -72,8 +344,22 @@ void MainWindow::setupChart()
     m_series->setColor(Qt::yellow);
     m_series->setPen(QPen(Qt::yellow, 2));
 
-    // Chart.
+    // Smith and polar grids, shown with their format.
+    auto makeGrid = [this](const QVector<QVector<QPointF>>& lines, QVector<QLineSeries *>& grid) {
+        for (const QVector<QPointF>& points : lines) {
+            QLineSeries *line = new QLineSeries(this);
+            line->setPen(QPen(QColor(90, 90, 90), 1));
+            line->replace(points);
+            line->setVisible(false);
+            grid.append(line);
+        }
+    };
+    makeGrid(smithGridLines(), m_smithGrid);
+    makeGrid(polarGridLines(), m_polarGrid);
+
+    // Chart (the grids first, under the trace).
     m_chart = new QChart();
+    for (QLineSeries *line : m_smithGrid + m_polarGrid) m_chart->addSeries(line);
     m_chart->addSeries(m_series);
     m_chart->setBackgroundBrush(QBrush(Qt::black));
     m_chart->setPlotAreaBackgroundBrush(QBrush(Qt::black));
@@ -105,11 +391,26 @@ void MainWindow::setupChart()
     m_chart->addAxis(m_axisY, Qt::AlignLeft);
     m_series->attachAxis(m_axisX);
     m_series->attachAxis(m_axisY);
+    for (QLineSeries *line : m_smithGrid + m_polarGrid) {
+        line->attachAxis(m_axisX);
+        line->attachAxis(m_axisY);
+    }
+
+    // View, in the placeholder of the form.
+    QVBoxLayout *layout = new QVBoxLayout(ui->chart_placeholder);
+    layout->setContentsMargins(0, 0, 0, 0);
+    m_chartView = new QChartView(m_chart, ui->chart_placeholder);
+    m_chartView->setBackgroundBrush(QBrush(Qt::black));
+    m_chartView->setRenderHint(QPainter::Antialiasing);
+    layout->addWidget(m_chartView);
+    Metrics::instance().markStartup("chart");
 
-    // View.
-    ui->s11_chartView->setChart(m_chart);
-    ui->s11_chartView->setBackgroundBrush(QBrush(Qt::black));
-    ui->s11_chartView->setRenderHint(QPainter::Antialiasing);
+    // Format selected and trace received meanwhile.
+    applyFormatAxes();
+    if (!m_pendingGraph.isEmpty()) {
+        onSetupGraph(m_pendingGraph, m_pendingStartFreq, m_pendingStopFreq);
+        m_pendingGraph.clear();
+    }
 }
 
 // Dynamically update the X axis.
@@ -127,3 +428,22 @@ void MainWindow::updateXAxisRange(double startFreq, double stopFreq)
 
     m_axisX->setRange(startMhz, stopMhz);
 }
+
+// Fit the Y axis to the data for formats without a fixed scale.
+void MainWindow::updateYAxisRange(const QVector<QPointF>& data)
+{
+    if (!m_axisY || data.isEmpty()) return;
+
+    double minY = data.first().y();
+    double maxY = minY;
+    for (const QPointF& p : data) {
+        minY = std::min(minY, p.y());
+        maxY = std::max(maxY, p.y());
+    }
+
+    // Protection against a flat trace.
+    double margin = (maxY - minY) * 0.05;
+    if (margin <= 0.0) margin = 1.0;
+
+    m_axisY->setRange(minY - margin, maxY + margin);
+}
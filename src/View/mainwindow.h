@@ -4,6 +4,8 @@
 #define MAINWINDOW_H
 
 #include "Interfaces/IVnaView.h"
+#include "Model/TraceFormats.h"
+#include "Model/TraceMath.h"
 #include "ui_mainwindow.h"
 
 #include <QtCharts/QValueAxis>
@@ -37,22 +39,78 @@ public:
                       double startGhz,
                       double stopGhz) override;
 
+    void onWaterfallUpdated(const QVector<double>& magDb) override;
+
+    void onTrendUpdated(const TrendSeries& series) override;
+
+    void onTuneStatus(double predictedHz,
+                        double achievedHz) override;
+
+    void onFrameStats(quint64 processed,
+                        quint64 displayed,
+                        quint64 dropped) override;
+
+    void onLimitVerdict(bool passed,
+                        double worstMarginDb,
+                        double worstFreqMhz,
+                        int failedPoints) override;
+
+
+protected:
+    // Queues the chart construction after the first paint.
+    bool event(QEvent *event) override;
 
 private slots:
     // "Measure" button handler.
     void onMeasureButtonClicked();
 
+    // "Limit mask" button handler.
+    void onLimitsButtonClicked();
+
+    // "Test plan" button handler.
+    void onSequenceButtonClicked();
+
+    // "Fixture" button handler.
+    void onFixtureButtonClicked();
+
+    // "Export" button handler.
+    void onExportButtonClicked();
+
+    // "Tune" button / "Auto" check box handler.
+    void onTuneButtonClicked();
+
+    // Trace format selector handler.
+    void onFormatChanged(int index);
+
+    // Trace math / hold selector handler.
+    void onTraceMathChanged();
+
 private:
     Ui::MainWindow *ui;
     QLineSeries *m_series = nullptr;
     QChart *m_chart = nullptr;
     QValueAxis *m_axisX = nullptr;
     QValueAxis *m_axisY = nullptr;
+    QChartView *m_chartView = nullptr;
+    QVector<QLineSeries *> m_smithGrid;
+    QVector<QLineSeries *> m_polarGrid;
+    TraceFormat m_format = TraceFormat::LogMag;
+
+    // Deferred chart: the trace received before it exists, first-trace mark.
+    bool m_chartQueued = false;
+    bool m_traceShown = false;
+    QVector<QPointF> m_pendingGraph;
+    double m_pendingStartFreq = 0.0;
+    double m_pendingStopFreq = 0.0;
 
     // Styling the graph.
     void setupChart();
+    // Axis ranges and labels of the displayed format.
+    void applyFormatAxes();
     // Dynamically update the X axis.
     void updateXAxisRange(double startFreq, double stopFreq);
+    // Fit the Y axis to the data for formats without a fixed scale.
+    void updateYAxisRange(const QVector<QPointF>& data);
 
 };
 
@@ -0,0 +1,36 @@
+// Export worker. Writes Touchstone files in a separate thread.
+
+#include "Workers/ExportWorker.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+
+// !! Runs in a separate thread. !!
+ExportWorker::ExportWorker(QObject *parent)
+    : QObject(parent){}
+
+// Write a 1-port sweep (S11) to a Touchstone file, on the sweep's own grid.
+void ExportWorker::exportSweep(const SweepPtr& sweep,
+                                const QString& path,
+                                int format,
+                                int version)
+{
+    TouchstoneOptions options;
+    options.version = version;
+    options.format = TouchstoneFormat(format);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString error;
+    bool ok = m_writer.write(path, { sweep }, options, &error);
+    m_busy.store(false, std::memory_order_release);
+
+    if (ok) {
+        emit exportFinished(QString("Status: Exported %1 (%2 ms)")
+                                .arg(QFileInfo(path).fileName()).arg(timer.elapsed()));
+    } else {
+        emit exportFinished(QString("Status: Export error - %1").arg(error));
+    }
+}
@@ -0,0 +1,44 @@
+// Export worker. Writes Touchstone files in a separate thread.
+
+#ifndef EXPORTWORKER_H
+#define EXPORTWORKER_H
+
+#include "Model/SweepData.h"
+#include "Model/TouchstoneWriter.h"
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+
+
+// !! Runs in a separate thread. !!
+class ExportWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ExportWorker(QObject *parent = nullptr);
+    ~ExportWorker() override = default;
+
+    // True while an export is queued or running (checked from the main thread
+    // to skip a continuous export instead of queueing a backlog).
+    bool isBusy() const { return m_busy.load(std::memory_order_acquire); }
+    void markBusy() { m_busy.store(true, std::memory_order_release); }
+
+public slots:
+    // Write a 1-port sweep (S11) to a Touchstone file, on the sweep's own grid.
+    void exportSweep(const SweepPtr& sweep,
+                        const QString& path,
+                        int format,
+                        int version);
+
+signals:
+    // Export status for the View.
+    void exportFinished(const QString& msg);
+
+private:
+    TouchstoneWriter m_writer;          // Reused buffer between exports.
+    std::atomic<bool> m_busy{false};
+};
+
+#endif // EXPORTWORKER_H
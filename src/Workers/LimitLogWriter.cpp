@@ -0,0 +1,60 @@
+// Limit log worker. Writes pass/fail results to a CSV file in a separate thread.
+
+#include "Workers/LimitLogWriter.h"
+
+#include <QDateTime>
+
+
+// !! Runs in a separate thread. !!
+LimitLogWriter::LimitLogWriter(QObject *parent)
+    : QObject(parent){}
+
+// Destructor, flush the remaining records.
+LimitLogWriter::~LimitLogWriter()
+{
+    if (m_file.isOpen()) {
+        m_out.flush();
+        m_file.close();
+    }
+}
+
+// Open (append) the result log file.
+void LimitLogWriter::open(const QString& path)
+{
+    if (m_file.isOpen()) {
+        m_out.flush();
+        m_file.close();
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) return;
+
+    m_out.setDevice(&m_file);
+    if (m_file.size() == 0) {
+        m_out << "time,sweep,verdict,worst_margin_db,worst_freq_mhz,failed_points\n";
+    }
+    m_unflushed = 0;
+}
+
+// Append one sweep verdict to the log.
+// Flushing is batched so that the disk is not touched on every sweep.
+void LimitLogWriter::appendVerdict(quint64 sweepIndex,
+                                    bool passed,
+                                    double worstMarginDb,
+                                    double worstFreqHz,
+                                    int failedPoints)
+{
+    if (!m_file.isOpen()) return;
+
+    m_out << QDateTime::currentDateTime().toString(Qt::ISODateWithMs) << ','
+          << sweepIndex << ','
+          << (passed ? "PASS" : "FAIL") << ','
+          << QString::number(worstMarginDb, 'f', 3) << ','
+          << QString::number(worstFreqHz / 1e6, 'f', 6) << ','
+          << failedPoints << '\n';
+
+    if (++m_unflushed >= 32) {
+        m_out.flush();
+        m_unflushed = 0;
+    }
+}
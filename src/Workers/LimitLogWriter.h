@@ -0,0 +1,37 @@
+// Limit log worker. Writes pass/fail results to a CSV file in a separate thread.
+
+#ifndef LIMITLOGWRITER_H
+#define LIMITLOGWRITER_H
+
+#include <QObject>
+#include <QFile>
+#include <QTextStream>
+
+
+// !! Runs in a separate thread. !!
+class LimitLogWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LimitLogWriter(QObject *parent = nullptr);
+    ~LimitLogWriter() override;
+
+public slots:
+    // Open (append) the result log file.
+    void open(const QString& path);
+
+    // Append one sweep verdict to the log.
+    void appendVerdict(quint64 sweepIndex,
+                        bool passed,
+                        double worstMarginDb,
+                        double worstFreqHz,
+                        int failedPoints);
+
+private:
+    QFile m_file;
+    QTextStream m_out;
+    int m_unflushed = 0;
+};
+
+#endif // LIMITLOGWRITER_H
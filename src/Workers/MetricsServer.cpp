@@ -0,0 +1,53 @@
+// Metrics server. Serves the metrics in Prometheus text format on localhost.
+// Minimal HTTP/1.0: any GET returns the metrics and closes the connection.
+
+#include "Workers/MetricsServer.h"
+#include "Model/Metrics.h"
+
+
+// !! Runs in a separate thread. !!
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent){}
+
+// Listen on 127.0.0.1:port.
+void MetricsServer::start(quint16 port)
+{
+    if (port == 0 || m_server) return;
+
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        qWarning("Metrics server: cannot listen on port %u", unsigned(port));
+    }
+}
+
+// New scrape connection.
+void MetricsServer::onNewConnection()
+{
+    while (QTcpSocket *client = m_server->nextPendingConnection()) {
+        connect(client, &QTcpSocket::readyRead, this, [this, client]() { onClientReadyRead(client); });
+        connect(client, &QTcpSocket::disconnected, client, &QObject::deleteLater);
+    }
+}
+
+// Answer once the request header is complete.
+void MetricsServer::onClientReadyRead(QTcpSocket *client)
+{
+    // Requests are tiny; drop clients that send garbage without ending the header.
+    if (client->bytesAvailable() > 8192) {
+        client->abort();
+        return;
+    }
+    if (!client->peek(8192).contains("\r\n\r\n")) return;
+    client->readAll();
+
+    const QByteArray body = Metrics::instance().prometheusText();
+    QByteArray response = "HTTP/1.0 200 OK\r\n"
+                          "Content-Type: text/plain; version=0.0.4\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n";
+    response += body;
+
+    client->write(response);
+    client->disconnectFromHost();
+}
@@ -0,0 +1,35 @@
+// Metrics server. Serves the metrics in Prometheus text format on localhost.
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+
+// !! Runs in a separate thread. !!
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+    ~MetricsServer() override = default;
+
+public slots:
+    // Listen on 127.0.0.1:port (0 = disabled).
+    void start(quint16 port);
+
+private slots:
+    // New scrape connection.
+    void onNewConnection();
+
+private:
+    // Answer once the request header is complete.
+    void onClientReadyRead(QTcpSocket *client);
+
+    QTcpServer *m_server = nullptr;
+};
+
+#endif // METRICSSERVER_H
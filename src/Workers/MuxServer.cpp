@@ -0,0 +1,95 @@
+// Multiplexing server. Lets several local clients share the one instrument connection.
+// Commands of all clients are serialized onto the ScpiClient socket; each reply is routed
+// by its tag (the client id). Sweeps are written from one implicitly shared buffer, and a
+// client whose send queue is full skips sweeps instead of stalling the others.
+
+#include "Workers/MuxServer.h"
+
+
+// !! Runs in the Worker thread. !!
+MuxServer::MuxServer(QObject *parent)
+    : QObject(parent)
+{
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &MuxServer::onNewConnection);
+}
+
+// Listen on 127.0.0.1:port.
+bool MuxServer::listen(quint16 port)
+{
+    return m_server->listen(QHostAddress::LocalHost, port);
+}
+
+// New client connection.
+void MuxServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        const quint64 id = m_nextId++;
+        m_clients.insert(id, Client{ socket, false, 0 });
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, id]() { onClientReadyRead(id); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, id]() { onClientDisconnected(id); });
+    }
+}
+
+// Split the client input into lines.
+void MuxServer::onClientReadyRead(quint64 id)
+{
+    auto it = m_clients.find(id);
+    if (it == m_clients.end()) return;
+
+    QTcpSocket *socket = it->socket;
+    while (socket->canReadLine()) {
+        const QByteArray line = socket->readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        const QByteArray upper = line.toUpper();
+        if (upper == "SUBSCRIBE") {
+            it->subscribed = true;
+        } else if (upper == "UNSUBSCRIBE") {
+            it->subscribed = false;
+        } else {
+            emit commandReceived(id, line);
+        }
+    }
+}
+
+void MuxServer::onClientDisconnected(quint64 id)
+{
+    auto it = m_clients.find(id);
+    if (it == m_clients.end()) return;
+    it->socket->deleteLater();
+    m_clients.erase(it);
+}
+
+// Fan out one sweep to all subscribers.
+void MuxServer::publishSweep(const QByteArray& rawData)
+{
+    for (Client& client : m_clients) {
+        if (!client.subscribed) continue;
+
+        // Slow subscriber: skip this sweep for it only.
+        if (client.socket->bytesToWrite() > m_maxPendingBytes) {
+            ++client.droppedSweeps;
+            continue;
+        }
+        client.socket->write("SWEEP ", 6);
+        client.socket->write(rawData);
+        client.socket->write("\n", 1);
+    }
+}
+
+// Route a reply line back to the client that sent the query.
+void MuxServer::deliverReply(quint64 tag, const QByteArray& reply)
+{
+    auto it = m_clients.find(tag);
+    if (it == m_clients.end()) return;          // Client already gone.
+    it->socket->write(reply);
+    it->socket->write("\n", 1);
+}
+
+// Tell a client that its command could not be sent.
+void MuxServer::deliverError(quint64 tag, const QByteArray& message)
+{
+    deliverReply(tag, "ERR " + message);
+}
@@ -0,0 +1,64 @@
+// Multiplexing server. Lets several local clients share the one instrument connection.
+
+#ifndef MUXSERVER_H
+#define MUXSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+
+
+// Line-based protocol on 127.0.0.1:
+//   SUBSCRIBE / UNSUBSCRIBE  - receive every acquired sweep as "SWEEP <raw ASCII data>".
+//   any other line           - forwarded to the instrument, replies come back in order.
+// !! Runs in the Worker thread. !!
+class MuxServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MuxServer(QObject *parent = nullptr);
+    ~MuxServer() override = default;
+
+    // Listen on 127.0.0.1:port.
+    bool listen(quint16 port);
+
+    // Subscriber send queue limit: a sweep is skipped for a client above it.
+    void setMaxPendingBytes(qint64 bytes) { m_maxPendingBytes = bytes; }
+
+public slots:
+    // Fan out one sweep to all subscribers from the shared buffer.
+    void publishSweep(const QByteArray& rawData);
+
+    // Route a reply line back to the client that sent the query.
+    void deliverReply(quint64 tag, const QByteArray& reply);
+
+    // Tell a client that its command could not be sent.
+    void deliverError(quint64 tag, const QByteArray& message);
+
+signals:
+    // Command line from a client, to be sent to the instrument.
+    void commandReceived(quint64 tag, const QByteArray& commandLine);
+
+private slots:
+    void onNewConnection();
+
+private:
+    struct Client
+    {
+        QTcpSocket *socket = nullptr;
+        bool subscribed = false;
+        quint64 droppedSweeps = 0;
+    };
+
+    void onClientReadyRead(quint64 id);
+    void onClientDisconnected(quint64 id);
+
+    QTcpServer *m_server = nullptr;
+    QHash<quint64, Client> m_clients;
+    quint64 m_nextId = 1;
+    qint64 m_maxPendingBytes = 16 << 20;
+};
+
+#endif // MUXSERVER_H
@@ -0,0 +1,123 @@
+// Sequence runner. Runs a test plan (list of measurement setups) for one DUT.
+
+#include "Workers/SequenceRunner.h"
+#include "Model/SweepParser.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QRegularExpression>
+
+#include <algorithm>
+
+
+// !! Runs in the Worker thread. !!
+SequenceRunner::SequenceRunner(IModel *client, QObject *parent)
+    : QObject(parent), m_client(client)
+{
+    connect(m_client, &IModel::sweepCompleted, this, &SequenceRunner::onSweepCompleted);
+    connect(m_client, &IModel::taggedSweepReceived, this, &SequenceRunner::onSweepReceived);
+}
+
+// Load a plan file. Empty lines and lines starting with '#' are skipped.
+bool SequenceRunner::loadPlan(const QString& path, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    QVector<SequenceStep> steps;
+    QTextStream in(&file);
+    int lineNumber = 0;
+
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        const QStringList parts = line.split(QRegularExpression("[\\s,;]+"), Qt::SkipEmptyParts);
+        bool ok[5] = {false, false, false, false, false};
+        SequenceStep step;
+
+        if (parts.size() == 6) {
+            step.name = parts[0];
+            step.config.startFreq = parts[1].toDouble(&ok[0]);
+            step.config.stopFreq = parts[2].toDouble(&ok[1]);
+            step.config.points = parts[3].toInt(&ok[2]);
+            step.config.power = parts[4].toDouble(&ok[3]);
+            step.config.ifBw = parts[5].toInt(&ok[4]);
+        }
+
+        if (!ok[0] || !ok[1] || !ok[2] || !ok[3] || !ok[4]
+            || step.config.stopFreq < step.config.startFreq || step.config.points < 2) {
+            if (error) *error = QString("Invalid plan line %1: %2").arg(lineNumber).arg(line);
+            return false;
+        }
+        steps.append(step);
+    }
+
+    if (steps.isEmpty()) {
+        if (error) *error = "Empty plan";
+        return false;
+    }
+    m_steps = steps;
+    return true;
+}
+
+// Run all steps once (one DUT).
+void SequenceRunner::start()
+{
+    if (m_running || m_steps.isEmpty()) return;
+
+    m_running = true;
+    m_sweepNs = 0;
+    m_clock.start();
+    m_lastDataNs = 0;
+    issueStep(0);
+}
+
+// Stop without finishing; late replies of the old run are ignored.
+void SequenceRunner::abort()
+{
+    m_running = false;
+}
+
+// Send the step's configuration and trigger its sweep (tag = step + 1).
+void SequenceRunner::issueStep(int index)
+{
+    const VnaConfig& cfg = m_steps[index].config;
+    m_stepStartNs = m_clock.nsecsElapsed();
+    m_client->setConfiguration(cfg.startFreq, cfg.stopFreq, cfg.points, cfg.power, cfg.ifBw);
+    m_client->requestSequenceSweep(quint64(index) + 1);
+}
+
+// The step's sweep is done on the instrument: configure the next step right away.
+// The instrument answers the queued data query first, then applies the next setup.
+void SequenceRunner::onSweepCompleted(quint64 tag)
+{
+    if (!m_running || tag == 0) return;
+    const int index = int(tag - 1);
+
+    // The instrument was busy with the previous step's data until it was received.
+    const qint64 now = m_clock.nsecsElapsed();
+    m_sweepNs += now - std::max(m_stepStartNs, m_lastDataNs);
+
+    if (index + 1 < m_steps.size()) issueStep(index + 1);
+}
+
+// The step's data arrived: put it on the step's grid and hand it over to be stored.
+void SequenceRunner::onSweepReceived(quint64 tag, const SweepPtr& sweep)
+{
+    if (!m_running || tag == 0 || int(tag) > m_steps.size()) return;
+    const int index = int(tag - 1);
+    m_lastDataNs = m_clock.nsecsElapsed();
+
+    emit stepMeasured(index, applySweepGrid(sweep, m_steps[index].config, quint64(index)));
+
+    if (index + 1 == m_steps.size()) {
+        m_running = false;
+        emit finished(m_steps.size(), m_clock.nsecsElapsed(), m_sweepNs);
+    }
+}
@@ -0,0 +1,78 @@
+// Sequence runner. Runs a test plan (list of measurement setups) for one DUT.
+
+#ifndef SEQUENCERUNNER_H
+#define SEQUENCERUNNER_H
+
+#include "Interfaces/IVnaModel.h"
+#include "Interfaces/IVnaConfig.h"
+#include "Model/SweepData.h"
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QElapsedTimer>
+
+
+// One measurement setup of the test plan.
+struct SequenceStep
+{
+    QString name;
+    VnaConfig config;
+};
+
+
+// !! Runs in the Worker thread. !!
+// Each step is configure -> sweep -> read -> store. The next step is configured as
+// soon as the instrument reports the current sweep done (*OPC?), so its setup and
+// sweep overlap the transfer and processing of the current data.
+class SequenceRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SequenceRunner(IModel *client, QObject *parent = nullptr);
+
+    // Load a plan file. Line format (frequencies in GHz, power in dBm, IF bandwidth in Hz):
+    // <name> <startGHz> <stopGHz> <points> <power> <ifBw>
+    bool loadPlan(const QString& path, QString* error = nullptr);
+
+    int stepCount() const { return m_steps.size(); }
+    const SequenceStep& step(int index) const { return m_steps[index]; }
+
+    bool isRunning() const { return m_running; }
+
+    // Run all steps once (one DUT).
+    void start();
+
+    // Stop without finishing (connection lost).
+    void abort();
+
+signals:
+    // Data of a step, on the grid of the step's setup.
+    void stepMeasured(int step, const SweepPtr& sweep);
+
+    // All steps done: total time and the time the instrument spent sweeping.
+    void finished(int steps, qint64 totalNs, qint64 sweepNs);
+
+private slots:
+    // Model->SequenceRunner: The step's sweep is done on the instrument.
+    void onSweepCompleted(quint64 tag);
+
+    // Model->SequenceRunner: The step's data arrived.
+    void onSweepReceived(quint64 tag, const SweepPtr& sweep);
+
+private:
+    // Send the step's configuration and trigger its sweep.
+    void issueStep(int index);
+
+    IModel *m_client = nullptr;
+    QVector<SequenceStep> m_steps;
+    bool m_running = false;
+
+    QElapsedTimer m_clock;              // Since start().
+    qint64 m_stepStartNs = 0;           // Instrument free for this step's setup.
+    qint64 m_lastDataNs = 0;            // Previous step's data fully received.
+    qint64 m_sweepNs = 0;               // Sum of the setup + sweep times.
+};
+
+#endif // SEQUENCERUNNER_H
@@ -1,6 +1,7 @@
 // Worker module. Performs measurements in a separate thread.
 
 #include "VnaWorker.h"
+#include "Model/Metrics.h"
 
 
 // !! Runs in a separate thread. !!
@@ -18,6 +19,7 @@ void VnaWorker::initialize()
 {
     if (m_client) return;
     m_client = new ScpiClient(this);
+    m_client->setTransportOptions(m_transportOptions);
 
     // Model->VnaWorker: Socket status: connected / disconnected.
     connect(m_client, &ScpiClient::connected, this, &VnaWorker::onConnected);
@@ -26,6 +28,56 @@ void VnaWorker::initialize()
     connect(m_client, &ScpiClient::configurationReceived, this, &VnaWorker::onConfigurationReceived);
     // Model->VnaWorker: Received schedule from the socket.
     connect(m_client, &ScpiClient::sParametersReceived, this, &VnaWorker::onSParametersReceived);
+
+    // SequenceRunner->Worker: Test plan steps (the runner drives the same client).
+    m_sequence = new SequenceRunner(m_client, this);
+    connect(m_sequence, &SequenceRunner::stepMeasured, this, &VnaWorker::onSequenceStep);
+    connect(m_sequence, &SequenceRunner::finished, this, &VnaWorker::onSequenceFinished);
+
+    if (m_muxPort != 0) setMuxPort(m_muxPort);
+}
+
+// Start the local multiplexing server on 127.0.0.1:port.
+void VnaWorker::setMuxPort(quint16 port)
+{
+    m_muxPort = port;
+    if (port == 0 || !m_client || m_mux) return;
+
+    m_mux = new MuxServer(this);
+    if (!m_mux->listen(port)) {
+        emit statusChanged(QString("Status: Cannot listen on port %1").arg(port));
+        m_mux->deleteLater();
+        m_mux = nullptr;
+        return;
+    }
+    connectMux();
+}
+
+// Connect the ScpiClient replies to the multiplexing server.
+void VnaWorker::connectMux()
+{
+    // MuxServer->Worker->Model: Commands of the local clients.
+    connect(m_mux, &MuxServer::commandReceived, this, &VnaWorker::onMuxCommand);
+    // Model->MuxServer: Replies and the sweep fan-out (same thread, shared buffer).
+    connect(m_client, &ScpiClient::rawReplyReceived, m_mux, &MuxServer::deliverReply);
+    connect(m_client, &ScpiClient::sweepBytesReceived, m_mux, &MuxServer::publishSweep);
+}
+
+// MuxServer->Worker: Command line from a local client, serialized onto the one socket.
+void VnaWorker::onMuxCommand(quint64 tag, const QByteArray& commandLine)
+{
+    if (!m_client->isConnected()) {
+        m_mux->deliverError(tag, "not connected");
+        return;
+    }
+    m_client->sendRaw(tag, commandLine);
+}
+
+// Capture / replay selection for the ScpiClient.
+void VnaWorker::setTransportOptions(const ScpiTransportOptions& options)
+{
+    m_transportOptions = options;
+    if (m_client) m_client->setTransportOptions(options);
 }
 
 // "Measure" button signal.
@@ -61,28 +113,71 @@ void VnaWorker::startMeasurementWithParams(double startFreq,
     }
 }
 
+// Run a test plan file once. The automatic update is paused so that no other
+// sweep is queued between the steps.
+void VnaWorker::runSequence(const QString& planPath)
+{
+    if (m_sequence->isRunning()) {
+        emit statusChanged("Status: Sequence already running");
+        return;
+    }
+    if (!m_client->isConnected()) {
+        emit statusChanged("Status: Not connected to server...");
+        return;
+    }
+
+    QString error;
+    if (!m_sequence->loadPlan(planPath, &error)) {
+        emit statusChanged(QString("Status: Plan error - %1").arg(error));
+        return;
+    }
+
+    stopAutoUpdate();
+    emit statusChanged(QString("Status: Running %1 step(s)...").arg(m_sequence->stepCount()));
+    emit sequenceStarted(planPath);
+    m_sequence->start();
+}
+
+// SequenceRunner->Worker: Step data. The step's setup is reported first (in the
+// instrument's units, Hz) so the displayed grid matches the sweep that follows it.
+void VnaWorker::onSequenceStep(int step, const SweepPtr& sweep)
+{
+    const SequenceStep& s = m_sequence->step(step);
+    emit configurationReceived(s.config.startFreq * 1e9, s.config.stopFreq * 1e9, s.config.points,
+                               s.config.power, s.config.ifBw);
+    emit sequenceStepMeasured(step, s.name, sweep);
+}
+
+// SequenceRunner->Worker: All steps done, resume the automatic update.
+void VnaWorker::onSequenceFinished(int steps, qint64 totalNs, qint64 sweepNs)
+{
+    emit sequenceFinished(steps, totalNs, sweepNs);
+    if (m_client->isConnected()) startAutoUpdate();
+}
+
 // Connecting to the socket with host and port.
 void VnaWorker::attemptConnect()
 {
+    Metrics::instance().connectAttempts.add();
     m_timer->stop();                // Stop old timer.
     m_client->abort();              // Reset the old connection.
+    m_graphInFlight = false;        // (its requests are dropped with it)
     emit statusChanged("Status: Initiating connection...");
+    m_timer->start(5000);           // Trying 5 sec (a replay connects inside connectTo()).
     m_client->connectTo("127.0.0.1", 5025);
-    m_timer->start(5000);           // Trying 5 sec.
 }
 
 // Successful connection to socket.
 void VnaWorker::onConnected()
 {
     m_timer->stop();
+    Metrics::instance().markStartup("connected");
+    if (m_connectedOnce) Metrics::instance().reconnects.add();
+    m_connectedOnce = true;
     emit statusChanged("Status: Connected to S2VNA!");
 
-    // Start timer automatic graph update.
-    if (!m_autoUpdateTimer) {
-        m_autoUpdateTimer = new QTimer(this);
-        connect(m_autoUpdateTimer, &QTimer::timeout, this, &VnaWorker::requestGraphOnly);
-    }
-    m_autoUpdateTimer->start(300);
+    // Start automatic graph update.
+    startAutoUpdate();
 
     // Call the required method after connection: without parameters / with parameters.
     switch (m_pendingMeasurement)
@@ -108,13 +203,14 @@ void VnaWorker::onConnected()
 // Socket disconnect.
 void VnaWorker::onDisconnected()
 {
+    Metrics::instance().disconnects.add();
     emit statusChanged("Status: Connection lost...");
     m_pendingMeasurement = MeasurementType::None;
+    if (m_sequence) m_sequence->abort();
 
-    // Stop timer automatic graph update.
-    if (m_autoUpdateTimer) {
-        m_autoUpdateTimer->stop();
-    }
+    // Stop automatic graph update (the client dropped the request in flight).
+    stopAutoUpdate();
+    m_graphInFlight = false;
 }
 
 // The connection was not established after a timeout.
@@ -152,19 +248,50 @@ void VnaWorker::onConfigurationReceived(double startFreq,
 }
 
 // Model->Worker->Presenter: Transport graph data from socket.
-void VnaWorker::onSParametersReceived(const QString& rawData)
+void VnaWorker::onSParametersReceived(const SweepPtr& sweep)
+{
+    Metrics& metrics = Metrics::instance();
+    metrics.sweepsReceived.add();
+    if (metrics.sweepsReceived.value() == 1) metrics.markStartup("first_sweep");
+    if (m_sweepClock.isValid()) metrics.sweepIntervalNs.record(m_sweepClock.nsecsElapsed());
+    m_sweepClock.start();
+
+    // Replies come in request order, so the automatic request is answered by now.
+    // The next one goes out from the event loop (a replay answers inside the request).
+    m_graphInFlight = false;
+    if (m_autoUpdate) m_autoUpdateTimer->start(0);
+
+    emit sParametersReceived(sweep);
+}
+
+// Start the automatic graph update: one request in flight, the next one as soon
+// as its reply is complete, so the sweep rate is the instrument's own.
+void VnaWorker::startAutoUpdate()
+{
+    if (!m_autoUpdateTimer) {
+        m_autoUpdateTimer = new QTimer(this);
+        m_autoUpdateTimer->setSingleShot(true);
+        connect(m_autoUpdateTimer, &QTimer::timeout, this, &VnaWorker::requestGraphOnly);
+    }
+    m_autoUpdate = true;
+    m_autoUpdateTimer->start(0);
+}
+
+// Stop the automatic graph update (a request in flight is still answered).
+void VnaWorker::stopAutoUpdate()
 {
-    emit sParametersReceived(rawData);
+    m_autoUpdate = false;
+    if (m_autoUpdateTimer) m_autoUpdateTimer->stop();
 }
 
 // Automatic chart update.
 void VnaWorker::requestGraphOnly()
 {
     if (!m_client || !m_client->isConnected()) {
-        if (m_autoUpdateTimer) {
-            m_autoUpdateTimer->stop();
-        }
+        stopAutoUpdate();
         return;
     }
+    if (m_graphInFlight) return;
+    m_graphInFlight = true;
     m_client->requestSParamsGraph();
 }
@@ -5,12 +5,15 @@
 
 #include "Interfaces/IVnaModel.h"
 #include "Model/VnaScpiClient.h"
+#include "Workers/MuxServer.h"
+#include "Workers/SequenceRunner.h"
 
 #include <QObject>
 #include <QMetaObject>
 #include <QTimer>
 #include <qDebug>
 #include <QThread>
+#include <QElapsedTimer>
 
 
 // !! Runs in a separate thread. !!
@@ -26,9 +29,18 @@ public slots:
     // ScpiClient thread initialization.
     void initialize();
 
+    // Capture / replay selection for the ScpiClient.
+    void setTransportOptions(const ScpiTransportOptions& options);
+
+    // Start the local multiplexing server on 127.0.0.1:port (0 = off).
+    void setMuxPort(quint16 port);
+
     // View->Presenter: Measure button signal.
     void startMeasurement();
 
+    // View->Presenter: Run a test plan file once (one DUT).
+    void runSequence(const QString& planPath);
+
     // View->Presenter: Measure button signal with parameters.
     void startMeasurementWithParams(double startFreq,
                                     double stopFreq,
@@ -63,7 +75,7 @@ public slots:
                                     int ifBw);
 
     // Model->Worker->Presenter: Transport graph data from socket.
-    void onSParametersReceived(const QString& data);
+    void onSParametersReceived(const SweepPtr& sweep);
 
 signals:
     // Model->Worker->Presenter: Application status transport signal.
@@ -80,12 +92,26 @@ signals:
                                 int ifBw);
 
     // Receiving graph data from the socket.
-    void sParametersReceived(const QString& rawData);
+    void sParametersReceived(const SweepPtr& sweep);
+
+    // Test sequence: the plan was loaded and its run begins (one DUT).
+    void sequenceStarted(const QString& planPath);
+
+    // Test sequence: data of a step (on the step's grid) and the per-DUT timing.
+    void sequenceStepMeasured(int step, const QString& name, const SweepPtr& sweep);
+    void sequenceFinished(int steps, qint64 totalNs, qint64 sweepNs);
 
 private slots:
     // Automatic chart update.
     void requestGraphOnly();
 
+    // MuxServer->Worker: Command line from a local client.
+    void onMuxCommand(quint64 tag, const QByteArray& commandLine);
+
+    // SequenceRunner->Worker: Step data / all steps done.
+    void onSequenceStep(int step, const SweepPtr& sweep);
+    void onSequenceFinished(int steps, qint64 totalNs, qint64 sweepNs);
+
 private:
     // Data request status: with parameters / no parameters.
     enum class MeasurementType {
@@ -104,10 +130,25 @@ private:
 
     // Connecting to the device.
     void attemptConnect();
+    bool m_connectedOnce = false;       // A later connection is a reconnect.
 
     ScpiClient* m_client = nullptr;
+    ScpiTransportOptions m_transportOptions;
+    MuxServer *m_mux = nullptr;
+    SequenceRunner *m_sequence = nullptr;
+    quint16 m_muxPort = 0;
+
+    // Connect the ScpiClient replies to the multiplexing server.
+    void connectMux();
     QTimer *m_timer = nullptr;
     QTimer* m_autoUpdateTimer = nullptr;
+    QElapsedTimer m_sweepClock;         // Time since the previous sweep.
+    bool m_autoUpdate = false;          // Request the next sweep when one arrives.
+    bool m_graphInFlight = false;       // Automatic sweep request not answered yet.
+
+    // Automatic graph update on / off.
+    void startAutoUpdate();
+    void stopAutoUpdate();
 };
 
 
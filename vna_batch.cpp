@@ -0,0 +1,124 @@
+// Batch tool entry point.
+// Reprocesses saved sweeps (raw :CALC:DATA:SDAT? replies, Touchstone files) with the
+// client's parsers, trace formats, limit test and markers, on all cores.
+
+#include "Model/BatchProcessor.h"
+#include "Model/TouchstoneReader.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QRegularExpression>
+#include <algorithm>
+#include <cstdio>
+
+
+namespace {
+// Trace format by name: "logmag", "phase", "groupdelay", ... (spaces and units ignored).
+bool parseTraceFormat(const QString& name, TraceFormat* format)
+{
+    const QString wanted = name.toLower().remove(' ');
+    for (int i = 0; i < int(TraceFormat::Count); ++i) {
+        const QString candidate = traceFormatName(TraceFormat(i)).section(',', 0, 0).toLower().remove(' ');
+        if (candidate == wanted) {
+            *format = TraceFormat(i);
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("vna_batch");
+
+    // Command line options.
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Reprocess saved sweeps: limit verdicts, marker values and statistics.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "Sweep files or directories (*.txt, *.dat, *.csv raw replies; *.sNp Touchstone).", "inputs...");
+    QCommandLineOption limitsOption("limits", "Limit mask file (see LimitMask.h).", "file");
+    parser.addOption(limitsOption);
+    QCommandLineOption formatOption("format", "Trace format of the marker values (logmag, linmag, phase, groupdelay, swr, ...).", "format", "logmag");
+    parser.addOption(formatOption);
+    QCommandLineOption apertureOption("aperture", "Group delay aperture, steps.", "n", "1");
+    parser.addOption(apertureOption);
+    QCommandLineOption markersOption("markers", "Markers and bands, GHz, e.g. 1.5,2.0-2.5.", "channels");
+    parser.addOption(markersOption);
+    QCommandLineOption startOption("start", "Start frequency of the raw replies, GHz (required for them).", "ghz", "0");
+    parser.addOption(startOption);
+    QCommandLineOption stopOption("stop", "Stop frequency of the raw replies, GHz (required for them).", "ghz", "0");
+    parser.addOption(stopOption);
+    QCommandLineOption paramOption("param", "S-parameter taken from Touchstone files.", "sij", "S11");
+    parser.addOption(paramOption);
+    QCommandLineOption threadsOption("threads", "Worker threads (0 = one per core).", "n", "0");
+    parser.addOption(threadsOption);
+    QCommandLineOption outOption("out", "CSV result file (default: stdout, summary on stderr).", "file");
+    parser.addOption(outOption);
+    parser.process(app);
+
+    QTextStream err(stderr);
+    BatchOptions options;
+    QString error;
+
+    if (parser.isSet(limitsOption) && !options.mask.loadFromFile(parser.value(limitsOption), &error)) {
+        err << "Limit mask: " << error << "\n";
+        return 1;
+    }
+    if (!parseTraceFormat(parser.value(formatOption), &options.format)) {
+        err << "Unknown format: " << parser.value(formatOption) << "\n";
+        return 1;
+    }
+    if (parser.isSet(markersOption) && !parseTrendChannels(parser.value(markersOption), &options.markers, &error)) {
+        err << "Markers: " << error << "\n";
+        return 1;
+    }
+    options.aperture = parser.value(apertureOption).toInt();
+    if (options.aperture < 1) {
+        err << "Invalid aperture: " << parser.value(apertureOption) << "\n";
+        return 1;
+    }
+    const QRegularExpressionMatch param = QRegularExpression("^[sS]([1-9])([1-9])$").match(parser.value(paramOption));
+    if (!param.hasMatch()) {
+        err << "Invalid S-parameter: " << parser.value(paramOption) << "\n";
+        return 1;
+    }
+    options.row = param.captured(1).toInt() - 1;
+    options.col = param.captured(2).toInt() - 1;
+    options.rawStartHz = parser.value(startOption).toDouble() * 1e9;
+    options.rawStopHz = parser.value(stopOption).toDouble() * 1e9;
+    options.threads = parser.value(threadsOption).toInt();
+
+    const QStringList files = collectBatchFiles(parser.positionalArguments());
+    if (files.isEmpty()) {
+        err << "No input files\n";
+        return 1;
+    }
+    const bool rawInputs = std::any_of(files.cbegin(), files.cend(),
+                                       [](const QString& file) { return touchstonePorts(file) == 0; });
+    if (rawInputs && !(options.rawStopHz > options.rawStartHz)) {
+        err << "Raw replies carry no frequencies: give --start and --stop (stop > start)\n";
+        return 1;
+    }
+
+    // Results to the file (summary on stdout) or to stdout (summary on stderr).
+    QFile outFile;
+    QTextStream out(stdout);
+    if (parser.isSet(outOption)) {
+        outFile.setFileName(parser.value(outOption));
+        if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "Output: " << outFile.errorString() << "\n";
+            return 1;
+        }
+        out.setDevice(&outFile);
+    }
+
+    const BatchSummary summary = runBatch(files, options, out);
+    QTextStream summaryOut(parser.isSet(outOption) ? stdout : stderr);
+    printBatchSummary(summary, options, summaryOut);
+
+    return summary.errors > 0 ? 2 : 0;
+}